@@ -0,0 +1,97 @@
+#include<raylib.h>
+#include<math.h>
+#include "asset.h"
+#include "tween.h"
+using namespace std;
+class Circle
+{
+	
+private:
+	
+	// 转场时间线（秒）：黑圈扩张 -> 依次展示评测结果 -> 黑圈收缩
+	static constexpr float GROW_TIME = 1.3f;
+	static constexpr float PHOTO_START = 5.0f;
+	static constexpr float PHOTO_TIME = 2.0f;
+	static constexpr float SHRINK_TIME = 0.65f;
+	
+	bool active=false;
+	bool finished=false;   // 收缩结束，等待 in() 交还移动控制
+	float Circleradius=1.0f;
+	int photoIndex=-1;     // 当前展示的评测图片，-1 表示不展示
+	Timeline timeline{this};
+	
+	// 后台加载评测结果图片（转场开始 5 秒后才会用到）
+	TextureHandle texture_ce = RequestTexture("resource/ce.png");
+	TextureHandle texture_re = RequestTexture("resource/re.png");
+	TextureHandle texture_tle = RequestTexture("resource/tle.png");
+	TextureHandle texture_wa = RequestTexture("resource/wa.png");
+	TextureHandle texture_ac = RequestTexture("resource/ac.png");
+	
+	void DrawCentered(const TextureHandle& handle,int screenHeight,int screenWidth);
+	
+public:
+	
+	~Circle();
+	void start();
+	void out(int &canwalk,int screenHeight,int screenWidth);
+	void photo(int screenHeight,int screenWidth);
+	void in(int &canwalk);
+};
+Circle::~Circle()
+{
+	KillTweensOf(this);
+}
+void Circle::start()
+{
+	if(active)return;
+	active=true;
+	finished=false;
+	photoIndex=-1;
+	
+	float fullRadius=sqrt((float)GetScreenHeight()*GetScreenHeight()+(float)GetScreenWidth()*GetScreenWidth())+1.0f;
+	timeline=Timeline(this);
+	timeline.Then(GROW_TIME,1.0f,fullRadius,[this](float r){Circleradius=r;},EaseInCubic)
+	        .Wait(PHOTO_START-GROW_TIME);
+	for(int i=0;i<5;++i)
+	{
+		timeline.Call([this,i]{photoIndex=i;}).Wait(PHOTO_TIME);
+	}
+	timeline.Call([this]{photoIndex=-1;})
+	        .Then(SHRINK_TIME,fullRadius,-1.0f,[this](float r){Circleradius=r;},EaseOutQuad)
+	        .Call([this]{active=false;finished=true;});
+}
+void Circle::out(int &canwalk,int screenHeight,int screenWidth)
+{
+	if(active)
+	{
+		canwalk=0;
+		if(Circleradius>0)
+			DrawCircle(screenWidth/2.0f,screenHeight/2.0f,Circleradius,BLACK);
+	}
+}
+void Circle::DrawCentered(const TextureHandle& handle,int screenHeight,int screenWidth)
+{
+	Texture2D texture = handle.Get();
+	DrawTexture(texture, screenWidth/2 - texture.width/2, screenHeight/2 - texture.height/2, WHITE);
+}
+void Circle::photo(int screenHeight,int screenWidth)
+{
+	switch(photoIndex)
+	{
+		case 0: DrawCentered(texture_ce,screenHeight,screenWidth); break;
+		case 1: DrawCentered(texture_re,screenHeight,screenWidth); break;
+		case 2: DrawCentered(texture_tle,screenHeight,screenWidth); break;
+		case 3: DrawCentered(texture_wa,screenHeight,screenWidth); break;
+		case 4: DrawCentered(texture_ac,screenHeight,screenWidth); break;
+		default: break;
+	}
+}
+void Circle::in(int &canwalk)
+{
+	if(finished)
+	{
+		finished=false;
+		Circleradius=1.0f;
+		canwalk=1;
+	}
+}
@@ -0,0 +1,546 @@
+#include<bits/stdc++.h>
+#include "raylib.h"
+#include "nbsfont.h"
+#include "asset.h"
+#include "savefile.h"
+#include "snapshot.h"
+#include "tween.h"
+#include "particles.h"
+#include "uilayer.h"
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+using namespace std;
+typedef enum {
+	ACH_COMMON,
+	ACH_RARE
+} AchievementRarity;
+
+typedef struct {
+	std::string id;
+	std::string title;
+	std::string desc;
+	bool unlocked;
+	AchievementRarity rarity;
+	float showTimer;
+	Vector2 position;
+} Achievement;
+
+// ==================== 成就日志格式 ====================
+//
+// [魔数 "NBAJ"][版本 u32]
+// [记录]...   每条: 类型 u8 | 内容长度 u8 | 内容 | 校验 u32
+//   解锁记录: 内容 = 成就 id
+//   计数记录: 内容 = 当前值 i32 | 计数器名
+//
+// 只追加不改写；读取时遇到校验失败的记录（写到一半崩溃）即停止，之前的记录仍然有效。
+// 以 id 为键，成就列表增删或调整顺序都不影响已有存档。
+
+static const char ACH_JOURNAL_MAGIC[4] = {'N', 'B', 'A', 'J'};
+static const uint32_t ACH_JOURNAL_VERSION = 1;
+static const unsigned char ACH_RECORD_UNLOCK = 1;
+static const unsigned char ACH_RECORD_COUNTER = 2;
+static const int ACH_JOURNAL_COMPACT_LIMIT = 32; // 追加这么多条后在后台压缩一次
+
+// ==================== 统计事件队列 ====================
+
+/// 统计事件：计数器 stat 增加 amount
+struct StatEvent {
+	int stat;
+	int amount;
+};
+
+/// 有界无锁队列（多生产者、单消费者）：任意线程投递，主线程每帧取出汇总
+class StatEventQueue {
+private:
+	static const size_t CAPACITY = 4096; // 必须是 2 的幂
+
+	struct Cell {
+		std::atomic<size_t> sequence;
+		StatEvent event;
+	};
+
+	std::unique_ptr<Cell[]> cells;
+	std::atomic<size_t> enqueuePos;
+	size_t dequeuePos; // 只有消费者访问
+
+public:
+	StatEventQueue();
+
+	bool Push(const StatEvent& event); // 队列满时返回 false
+	bool Pop(StatEvent& event);
+};
+
+StatEventQueue::StatEventQueue() : cells(new Cell[CAPACITY]), enqueuePos(0), dequeuePos(0) {
+	for (size_t i = 0; i < CAPACITY; ++i) {
+		cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+}
+
+bool StatEventQueue::Push(const StatEvent& event) {
+	size_t pos = enqueuePos.load(std::memory_order_relaxed);
+	while (true) {
+		Cell& cell = cells[pos & (CAPACITY - 1)];
+		size_t sequence = cell.sequence.load(std::memory_order_acquire);
+		intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+		if (diff == 0) {
+			// 抢到这个格子后再写入，写完用 sequence 通知消费者
+			if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+				cell.event = event;
+				cell.sequence.store(pos + 1, std::memory_order_release);
+				return true;
+			}
+		} else if (diff < 0) {
+			return false;
+		} else {
+			pos = enqueuePos.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+bool StatEventQueue::Pop(StatEvent& event) {
+	Cell& cell = cells[dequeuePos & (CAPACITY - 1)];
+	size_t sequence = cell.sequence.load(std::memory_order_acquire);
+	if (sequence != dequeuePos + 1) return false;
+
+	event = cell.event;
+	cell.sequence.store(dequeuePos + CAPACITY, std::memory_order_release);
+	++dequeuePos;
+	return true;
+}
+
+class AchievementSystem {
+public:
+	AchievementSystem() : journalPath("save/achievement.journal"), journalRecords(0) {}
+	~AchievementSystem() {
+		KillTweensOf(this);
+		for (int panel : toastPanels) ReleaseUiPanel(panel);
+	}
+
+	void Save(); // 压缩日志并等待后台写入完成（退出前调用）
+	void Read();
+	void Init();
+	void Update();
+	void Draw();
+	void AddAchievement(Achievement ach);
+	void Unlock(const std::string& id);
+
+	// 计数器：在 Read 之前注册并关联成就
+	int RegisterStat(const std::string& name);                  // 同名返回同一个编号
+	void LinkStat(const std::string& id, int stat, int threshold); // 计数达到 threshold 时解锁 id
+	bool PostStat(int stat, int amount = 1);                    // 任意线程可调用，无锁；队列满时返回 false
+	int GetStat(int stat) const;
+
+	// 存档快照：成就只增不减，读档时不会撤销之后获得的成就和进度
+	void SaveState(SnapshotWriter& out) const;
+	bool LoadState(SnapshotReader& in);
+
+private:
+	struct StatLink {
+		size_t achievement;
+		int threshold;
+	};
+
+	std::vector < Achievement > achievements;
+	std::unordered_map<std::string, size_t> achievementIndex; // id -> achievements 下标
+	Sound unlockSound;
+	TextureHandle commonTex;
+	TextureHandle rareTex;
+	std::vector<int> toastPanels; // 与 achievements 一一对应，提示框显示期间占用一个 UI 面板，-1 表示没有
+
+	// 计数器（下标即编号，只在主线程访问）
+	std::vector<std::string> statNames;
+	std::vector<int> statValues;
+	std::vector<int> statPending;                 // 本帧汇总中的增量
+	std::vector<int> statsChanged;                // 本帧有事件的计数器
+	std::vector<std::vector<StatLink>> statLinks; // 计数器 -> 依赖它的成就（预先建立）
+	StatEventQueue statEvents;
+
+	// 存档日志
+	std::string journalPath;
+	std::set<std::string> journalIds;         // 已解锁的 id（包括当前列表中已不存在的）
+	std::map<std::string, int> journalCounters; // 计数器最新值（同上）
+	int journalRecords;                       // 日志中的记录条数（含重复）
+	BackgroundWriter journalWriter;
+
+	void UnlockAt(size_t index, bool notify);
+	void ProcessStats();
+	void CheckStatLinks(int stat, bool notify);
+
+	bool ReadJournal();
+	void ReadLegacySave();
+	void AppendJournal(const std::string& records, int recordCount);
+	void CompactJournal();
+};
+
+void AchievementSystem::Init() {
+	unlockSound = LoadSound("sounds/unlock.wav");
+	commonTex = RequestTexture("textures/achievement_common.png", BLANK);
+	rareTex = RequestTexture("textures/achievement_rare.png", BLANK);
+}
+
+void AchievementSystem::AddAchievement(Achievement ach) {
+	ach.position = {-400, 20}; // 初始位置在屏幕左侧外
+	achievementIndex[ach.id] = achievements.size();
+	achievements.push_back(ach);
+	toastPanels.push_back(-1);
+}
+
+int AchievementSystem::RegisterStat(const std::string& name) {
+	for (size_t i = 0; i < statNames.size(); ++i) {
+		if (statNames[i] == name) return (int)i;
+	}
+	auto saved = journalCounters.find(name);
+	statNames.push_back(name);
+	statValues.push_back(saved != journalCounters.end() ? saved->second : 0);
+	statPending.push_back(0);
+	statLinks.emplace_back();
+	return (int)statNames.size() - 1;
+}
+
+void AchievementSystem::LinkStat(const std::string& id, int stat, int threshold) {
+	auto it = achievementIndex.find(id);
+	if (it == achievementIndex.end() || stat < 0 || stat >= (int)statLinks.size()) return;
+
+	statLinks[stat].push_back({it->second, threshold});
+	if (statValues[stat] >= threshold) {
+		UnlockAt(it->second, false);
+	}
+}
+
+bool AchievementSystem::PostStat(int stat, int amount) {
+	return statEvents.Push({stat, amount});
+}
+
+int AchievementSystem::GetStat(int stat) const {
+	return stat >= 0 && stat < (int)statValues.size() ? statValues[stat] : 0;
+}
+
+static void AppendJournalRecord(std::string& buffer, unsigned char type, const std::string& payload) {
+	size_t begin = buffer.size();
+	unsigned char length = (unsigned char)std::min<size_t>(payload.size(), 255);
+	buffer.push_back((char)type);
+	buffer.push_back((char)length);
+	buffer.append(payload, 0, length);
+	uint32_t checksum = SaveChecksum(buffer.data() + begin, buffer.size() - begin);
+	buffer.append((const char*)&checksum, sizeof(checksum));
+}
+
+static void AppendCounterRecord(std::string& buffer, const std::string& name, int32_t value) {
+	std::string payload((const char*)&value, sizeof(value));
+	payload += name;
+	AppendJournalRecord(buffer, ACH_RECORD_COUNTER, payload);
+}
+
+static std::string JournalHeader() {
+	std::string header(ACH_JOURNAL_MAGIC, 4);
+	header.append((const char*)&ACH_JOURNAL_VERSION, sizeof(ACH_JOURNAL_VERSION));
+	return header;
+}
+
+void AchievementSystem::Save() {
+	CompactJournal();
+	journalWriter.Flush();
+}
+
+void AchievementSystem::Read() {
+	journalIds.clear();
+	journalCounters.clear();
+	journalRecords = 0;
+	bool hasJournal = ReadJournal();
+	if (hasJournal) {
+		for (auto& ach : achievements) {
+			ach.unlocked = journalIds.count(ach.id) > 0;
+		}
+	} else {
+		// 没有日志：从旧版按行存档（或资源包中的模板）迁移
+		ReadLegacySave();
+	}
+
+	for (size_t i = 0; i < statNames.size(); ++i) {
+		auto saved = journalCounters.find(statNames[i]);
+		statValues[i] = saved != journalCounters.end() ? saved->second : 0;
+		CheckStatLinks((int)i, false); // 阈值调低后，已达标的成就直接解锁
+	}
+
+	if (!hasJournal || journalRecords > (int)(journalIds.size() + journalCounters.size())) {
+		CompactJournal(); // 迁移旧存档，或上次退出前没来得及压缩
+	}
+}
+
+bool AchievementSystem::ReadJournal() {
+	int size = 0;
+	unsigned char* data = LoadFileData(journalPath.c_str(), &size);
+	if (!data) return false;
+
+	std::string header = JournalHeader();
+	if (size < (int)header.size() || memcmp(data, header.data(), header.size()) != 0) {
+		TraceLog(LOG_WARNING, "ACH: [%s] 日志头无效，忽略", journalPath.c_str());
+		UnloadFileData(data);
+		return false;
+	}
+
+	int cursor = (int)header.size();
+	while (cursor + 2 <= size) {
+		unsigned char type = data[cursor];
+		int length = data[cursor + 1];
+		int recordSize = 2 + length + (int)sizeof(uint32_t);
+		if (cursor + recordSize > size) break; // 末尾记录没写完
+
+		uint32_t checksum;
+		memcpy(&checksum, data + cursor + 2 + length, sizeof(checksum));
+		if (checksum != SaveChecksum(data + cursor, 2 + length)) break;
+
+		const char* payload = (const char*)data + cursor + 2;
+		if (type == ACH_RECORD_UNLOCK) {
+			journalIds.insert(std::string(payload, length));
+		} else if (type == ACH_RECORD_COUNTER && length >= (int)sizeof(int32_t)) {
+			int32_t value;
+			memcpy(&value, payload, sizeof(value));
+			journalCounters[std::string(payload + sizeof(value), length - sizeof(value))] = value;
+		}
+		++journalRecords;
+		cursor += recordSize;
+	}
+	if (cursor != size) {
+		TraceLog(LOG_WARNING, "ACH: [%s] 丢弃末尾 %d 字节的残缺记录", journalPath.c_str(), size - cursor);
+		journalRecords = INT_MAX; // 强制压缩，去掉残缺的尾部
+	}
+	UnloadFileData(data);
+	return true;
+}
+
+void AchievementSystem::ReadLegacySave() {
+	ifstream fin;
+	fin.open("save/achievement.txt");
+	if (!fin.is_open()) {
+		// 首次运行还没有存档，使用资源包中的存档模板
+		PackData tmpl = assetPack.Load("save/achievement.txt");
+		size_t i = 0;
+		for (int k = 0; k < tmpl.size && i < achievements.size(); ++k) {
+			if (tmpl.data[k] == '0' || tmpl.data[k] == '1') {
+				achievements[i++].unlocked = tmpl.data[k] == '1';
+			}
+		}
+		UnloadPackData(tmpl);
+	} else {
+		for (size_t i = 0; i < achievements.size(); ++i) {
+			fin >> achievements[i].unlocked;
+		}
+		fin.close();
+	}
+	for (const auto& ach : achievements) {
+		if (ach.unlocked) journalIds.insert(ach.id);
+	}
+}
+
+void AchievementSystem::AppendJournal(const std::string& records, int recordCount) {
+	std::string path = journalPath;
+	journalWriter.Post([path, records] {
+		FILE* probe = fopen(path.c_str(), "rb");
+		std::string bytes = probe ? records : JournalHeader() + records;
+		if (probe) fclose(probe);
+		if (!AppendFileDurable(path, bytes.data(), bytes.size())) {
+			TraceLog(LOG_WARNING, "ACH: [%s] 追加失败", path.c_str());
+		}
+	});
+	journalRecords += recordCount;
+	if (journalRecords >= ACH_JOURNAL_COMPACT_LIMIT) {
+		CompactJournal();
+	}
+}
+
+void AchievementSystem::CompactJournal() {
+	// 在主线程生成快照（只有几百字节），写盘和改名交给后台线程
+	std::string bytes = JournalHeader();
+	for (const auto& id : journalIds) {
+		AppendJournalRecord(bytes, ACH_RECORD_UNLOCK, id);
+	}
+	for (const auto& [name, value] : journalCounters) {
+		AppendCounterRecord(bytes, name, value);
+	}
+	journalRecords = (int)(journalIds.size() + journalCounters.size());
+	std::string path = journalPath;
+	journalWriter.Post([path, bytes] {
+		if (!WriteFileAtomic(path, bytes.data(), bytes.size())) {
+			TraceLog(LOG_WARNING, "ACH: [%s] 压缩失败", path.c_str());
+		}
+	});
+}
+
+void AchievementSystem::Unlock(const std::string& id) {
+	auto it = achievementIndex.find(id);
+	if (it != achievementIndex.end()) {
+		UnlockAt(it->second, true);
+	}
+}
+
+void AchievementSystem::UnlockAt(size_t index, bool notify) {
+	Achievement& ach = achievements[index];
+	if (ach.unlocked) return;
+
+	AllowFrameAllocations(); // 写日志和弹出提示
+	ach.unlocked = true;
+	if (notify) {
+		// 提示框 0.5 秒内从左侧滑入，停留到 5 秒后消失
+		ach.position.x = -400;
+		// 提示框停稳时在框上撒一把亮片
+		ParticleEffect sparkle;
+		sparkle.layer = PARTICLE_SCREEN;
+		sparkle.count = ach.rarity == ACH_RARE ? 120 : 60;
+		sparkle.speedMin = 60.0f;
+		sparkle.speedMax = 240.0f;
+		sparkle.sizeStart = 5.0f;
+		sparkle.gravity = {0.0f, 300.0f};
+		sparkle.drag = 1.5f;
+		sparkle.radius = 30.0f;
+		sparkle.colorStart = ach.rarity == ACH_RARE ? Color{55, 160, 212, 255} : GOLD;
+		sparkle.colorEnd = {255, 255, 255, 0};
+		StartTween(-400, 20, 0.5f, [this, index](float x) { achievements[index].position.x = x; },
+		           EaseOutCubic, 0.0f, this, [sparkle]() { EmitParticles(sparkle, {220, 60}); });
+		StartTween(5.0f, 0.0f, 5.0f, [this, index](float t) { achievements[index].showTimer = t; },
+		           EaseLinear, 0.0f, this);
+		ach.showTimer = 5.0f;
+		PlaySound(unlockSound);
+	}
+	if (journalIds.insert(ach.id).second) {
+		std::string record;
+		AppendJournalRecord(record, ACH_RECORD_UNLOCK, ach.id);
+		AppendJournal(record, 1);
+	}
+}
+
+/// 汇总本帧投递的统计事件，只检查值发生变化的计数器所关联的成就
+void AchievementSystem::ProcessStats() {
+	StatEvent event;
+	while (statEvents.Pop(event)) {
+		if (event.stat < 0 || event.stat >= (int)statValues.size() || event.amount == 0) continue;
+		AllowFrameAllocations(); // 计数变化要追加日志
+		if (statPending[event.stat] == 0) statsChanged.push_back(event.stat);
+		statPending[event.stat] += event.amount;
+	}
+	if (statsChanged.empty()) return;
+
+	// 每个变化的计数器每帧只记一条日志
+	std::string records;
+	int recordCount = 0;
+	for (int stat : statsChanged) {
+		if (statPending[stat] == 0) continue; // 正负抵消
+		statValues[stat] += statPending[stat];
+		statPending[stat] = 0;
+		journalCounters[statNames[stat]] = statValues[stat];
+		AppendCounterRecord(records, statNames[stat], statValues[stat]);
+		++recordCount;
+	}
+	if (recordCount > 0) {
+		AppendJournal(records, recordCount);
+	}
+
+	for (int stat : statsChanged) {
+		CheckStatLinks(stat, true);
+	}
+	statsChanged.clear();
+}
+
+void AchievementSystem::CheckStatLinks(int stat, bool notify) {
+	for (const auto& link : statLinks[stat]) {
+		if (statValues[stat] >= link.threshold) {
+			UnlockAt(link.achievement, notify);
+		}
+	}
+}
+
+void AchievementSystem::SaveState(SnapshotWriter& out) const {
+	out.Write((uint32_t)journalIds.size());
+	for (const auto& id : journalIds) {
+		out.WriteString(id);
+	}
+	out.Write((uint32_t)statNames.size());
+	for (size_t i = 0; i < statNames.size(); ++i) {
+		out.WriteString(statNames[i]);
+		out.Write((int32_t)statValues[i]);
+	}
+}
+
+bool AchievementSystem::LoadState(SnapshotReader& in) {
+	uint32_t count = 0;
+	if (!in.Read(count)) return false;
+	for (uint32_t i = 0; i < count; ++i) {
+		std::string id;
+		if (!in.ReadString(id)) return false;
+		auto it = achievementIndex.find(id);
+		if (it != achievementIndex.end()) {
+			UnlockAt(it->second, false);
+		}
+	}
+
+	if (!in.Read(count)) return false;
+	std::string records;
+	int recordCount = 0;
+	for (uint32_t i = 0; i < count; ++i) {
+		std::string name;
+		int32_t value = 0;
+		if (!in.ReadString(name) || !in.Read(value)) return false;
+		auto stat = std::find(statNames.begin(), statNames.end(), name);
+		if (stat == statNames.end()) continue;
+
+		size_t index = stat - statNames.begin();
+		if (value > statValues[index]) {
+			statValues[index] = value;
+			journalCounters[name] = value;
+			AppendCounterRecord(records, name, value);
+			++recordCount;
+			CheckStatLinks((int)index, false);
+		}
+	}
+	if (recordCount > 0) {
+		AppendJournal(records, recordCount);
+	}
+	return true;
+}
+
+void AchievementSystem::Update() {
+	PROFILE_SCOPE("achievement update");
+	// 提示框的滑入和计时由补间调度器驱动（UpdateTweens）
+	ProcessStats();
+}
+
+void AchievementSystem::Draw() {
+	PROFILE_SCOPE("achievement draw");
+	for (size_t i = 0; i < achievements.size(); ++i) {
+		const Achievement& ach = achievements[i];
+		int& panel = toastPanels[i];
+		if (ach.showTimer <= 0) {
+			if (panel >= 0) {
+				ReleaseUiPanel(panel);
+				panel = -1;
+			}
+			continue;
+		}
+		if (panel < 0) panel = CreateUiPanel();
+
+		// 提示框内容在显示期间不变，只有图标异步加载完成时重画一次；滑入动画只移动面板
+		Texture2D icon = ach.rarity == ACH_RARE ? rareTex.Get() : commonTex.Get();
+		if (BeginUiPanel(panel, 402, 82, MixUiKey(UI_KEY_SEED, (int64_t)icon.id))) {
+			Color bgColor = ach.rarity == ACH_RARE ?
+			                Color{20, 20, 30, 220} : Color{30, 30, 40, 220};
+			Color borderColor = ach.rarity == ACH_RARE ?
+			                    Color{55, 160, 212, 255} : Color{212, 175, 55, 255};
+
+			// 绘制带圆角的成就框（四周留 1 像素给边线）
+			DrawRectangleRounded(Rectangle{1, 1, 400, 80}, 0.2f, 10, bgColor);
+			DrawRectangleRoundedLines(Rectangle{1, 1, 400, 80}, 0.2f, 10, borderColor);
+
+			// 绘制成就内容
+			DrawTexture(icon, 11, 11, WHITE);
+			DrawTextUTF(ach.title, Vector2{71, 21}, 24, 2, GOLD);
+			DrawTextUTF(ach.desc, Vector2{71, 51}, 18, 2, LIGHTGRAY);
+			EndUiPanel();
+		}
+		DrawUiPanel(panel, {ach.position.x - 1, ach.position.y - 1});
+	}
+}
+
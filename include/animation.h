@@ -0,0 +1,201 @@
+#ifndef ANIMATION_H
+#define ANIMATION_H
+
+#include "raylib.h"
+#include "asset.h"
+#include "profiler.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <cstdio>
+#include <cstdint>
+
+// ==================== 动画片段 ====================
+//
+// 精灵表按行分方向、按列分帧。LoadAnimationClip 按 (路径, 布局) 缓存，同一张表的所有角色
+// 共用一份片段：纹理句柄、帧时长和按 [方向][帧] 预先算好的源矩形表。片段在纹理就绪时建表，
+// 之后不再修改。
+
+struct SpriteSheetLayout {
+	int columns = 4;                     // 每行的帧数，即每个方向的帧数
+	int rows = 4;
+	int directionRows[4] = {0, 1, 2, 3}; // 下、左、右、上（Direction 的顺序）各用第几行
+	float frameTime = 0.1f;              // 每帧秒数
+};
+
+class AnimationClip {
+	friend std::shared_ptr<const AnimationClip> LoadAnimationClip(const std::string&, const SpriteSheetLayout&);
+private:
+	TextureHandle sheet;
+	SpriteSheetLayout layout;
+	int frameWidth = 0;
+	int frameHeight = 0;
+	std::vector<Rectangle> frames; // [方向 * columns + 帧]，就绪前为空
+
+	void BuildFrames() {
+		if (sheet.IsFailed()) return; // 备用纹理不是精灵表
+		Texture2D texture = sheet.Get();
+		frameWidth = texture.width / layout.columns;
+		frameHeight = texture.height / layout.rows;
+		frames.resize(4 * layout.columns);
+		for (int direction = 0; direction < 4; ++direction) {
+			for (int frame = 0; frame < layout.columns; ++frame) {
+				frames[direction * layout.columns + frame] = {
+					(float)(frame * frameWidth),
+					(float)(layout.directionRows[direction] * frameHeight),
+					(float)frameWidth,
+					(float)frameHeight
+				};
+			}
+		}
+	}
+
+public:
+	bool IsReady() const { return !frames.empty(); }
+	const TextureHandle& GetSheet() const { return sheet; }
+	int GetFrameCount() const { return layout.columns; }
+	float GetFrameTime() const { return layout.frameTime; }
+	int GetFrameWidth() const { return frameWidth; }
+	int GetFrameHeight() const { return frameHeight; }
+
+	// direction 为 Direction 的数值，frame 取 [0, GetFrameCount())
+	const Rectangle& GetFrame(int direction, int frame) const {
+		return frames[direction * layout.columns + frame];
+	}
+};
+
+typedef std::shared_ptr<const AnimationClip> AnimationClipHandle;
+
+static std::map<std::string, std::shared_ptr<AnimationClip>> animationClipCache;
+
+/// 获取精灵表的动画片段（同一路径和布局只加载一次）
+AnimationClipHandle LoadAnimationClip(const std::string& path, const SpriteSheetLayout& layout = SpriteSheetLayout()) {
+	char suffix[96];
+	snprintf(suffix, sizeof(suffix), "|%d,%d,%d,%d,%d,%d,%g", layout.columns, layout.rows,
+	         layout.directionRows[0], layout.directionRows[1], layout.directionRows[2], layout.directionRows[3],
+	         layout.frameTime);
+	std::string key = path + suffix;
+
+	auto& slot = animationClipCache[key];
+	if (!slot) {
+		slot = std::make_shared<AnimationClip>();
+		slot->layout = layout;
+		if (slot->layout.columns < 1) slot->layout.columns = 1;
+		if (slot->layout.rows < 1) slot->layout.rows = 1;
+		slot->sheet = RequestTexture(path, RED);
+		// 监听器属于片段自己的句柄，片段销毁时一起失效
+		AnimationClip* clip = slot.get();
+		slot->sheet.OnReady([clip]() { clip->BuildFrames(); });
+	}
+	return slot;
+}
+
+/// 释放没有角色在用的片段，返回释放的数量
+int ReleaseUnusedAnimationClips() {
+	int released = 0;
+	for (auto it = animationClipCache.begin(); it != animationClipCache.end();) {
+		if (it->second.use_count() == 1) {
+			it = animationClipCache.erase(it);
+			++released;
+		} else {
+			++it;
+		}
+	}
+	return released;
+}
+
+// ==================== 批量动画推进 ====================
+//
+// 每个动画实例（Animator）只有几个数，按字段存放在全局数组里。拥有者在自己的 Update 里
+// 调用 TickAnimator 登记本帧是否在播放和经过的时间，UpdateAnimations 每帧在一个循环里
+// 统一推进所有登记过的实例；本帧没有登记的实例保持不动（与原来不调用 Update 时一致）。
+
+typedef int AnimatorId;
+
+static std::vector<float> animatorTimer;
+static std::vector<float> animatorDelta;
+static std::vector<float> animatorFrameTime;
+static std::vector<uint16_t> animatorFrame;
+static std::vector<uint16_t> animatorFrameCount;
+static std::vector<uint8_t> animatorTicked;  // 本帧登记过
+static std::vector<uint8_t> animatorPlaying; // 登记时是否在播放
+static std::vector<AnimatorId> animatorFreeList;
+
+AnimatorId CreateAnimator() {
+	AnimatorId id;
+	if (!animatorFreeList.empty()) {
+		id = animatorFreeList.back();
+		animatorFreeList.pop_back();
+	} else {
+		id = (AnimatorId)animatorTimer.size();
+		animatorTimer.push_back(0.0f);
+		animatorDelta.push_back(0.0f);
+		animatorFrameTime.push_back(0.1f);
+		animatorFrame.push_back(0);
+		animatorFrameCount.push_back(1);
+		animatorTicked.push_back(0);
+		animatorPlaying.push_back(0);
+	}
+	animatorTimer[id] = 0.0f;
+	animatorDelta[id] = 0.0f;
+	animatorFrameTime[id] = 0.1f;
+	animatorFrame[id] = 0;
+	animatorFrameCount[id] = 1;
+	animatorTicked[id] = 0;
+	animatorPlaying[id] = 0;
+	return id;
+}
+
+void DestroyAnimator(AnimatorId id) {
+	if (id < 0 || id >= (AnimatorId)animatorTimer.size()) return;
+	animatorTicked[id] = 0;
+	animatorFreeList.push_back(id);
+}
+
+/// 换片段时调用：帧数和帧时长取自片段
+void SetAnimatorClip(AnimatorId id, const AnimationClip& clip) {
+	animatorFrameCount[id] = (uint16_t)(clip.GetFrameCount() > 0 ? clip.GetFrameCount() : 1);
+	animatorFrameTime[id] = clip.GetFrameTime();
+	animatorFrame[id] %= animatorFrameCount[id];
+}
+
+/// 登记本帧的推进，实际计算在 UpdateAnimations 中
+void TickAnimator(AnimatorId id, bool playing, float deltaTime) {
+	animatorTicked[id] = 1;
+	animatorPlaying[id] = playing ? 1 : 0;
+	animatorDelta[id] = deltaTime;
+}
+
+int GetAnimatorFrame(AnimatorId id) { return animatorFrame[id]; }
+float GetAnimatorTimer(AnimatorId id) { return animatorTimer[id]; }
+
+/// 读档/回溯时直接恢复
+void SetAnimatorState(AnimatorId id, int frame, float timer) {
+	animatorFrame[id] = (uint16_t)(frame >= 0 ? frame % animatorFrameCount[id] : 0);
+	animatorTimer[id] = timer;
+}
+
+/// 每帧在所有物体 Update 之后调用一次
+void UpdateAnimations() {
+	PROFILE_SCOPE("animations");
+	const size_t count = animatorTimer.size();
+	for (size_t i = 0; i < count; ++i) {
+		if (!animatorTicked[i]) continue;
+		animatorTicked[i] = 0;
+		if (!animatorPlaying[i]) {
+			// 停下时回到第一帧
+			animatorFrame[i] = 0;
+			animatorTimer[i] = 0.0f;
+			continue;
+		}
+		float timer = animatorTimer[i] + animatorDelta[i];
+		if (timer >= animatorFrameTime[i]) {
+			timer = 0.0f;
+			animatorFrame[i] = (uint16_t)((animatorFrame[i] + 1) % animatorFrameCount[i]);
+		}
+		animatorTimer[i] = timer;
+	}
+}
+
+#endif // ANIMATION_H
@@ -0,0 +1,312 @@
+#ifndef ASSET_H
+#define ASSET_H
+
+#include "raylib.h"
+#include "assetpack.h"
+#include "profiler.h"
+#include "input.h"
+#include <string>
+#include <map>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+
+/// 纹理资源的加载状态
+enum class AssetState {
+	LOADING, // 等待解码或上传，此时只能拿到占位纹理
+	READY,   // 已上传到显存
+	FAILED   // 文件读取失败，已上传备用纹理
+};
+
+/// 纹理资源槽：工作线程解码 Image，主线程上传为 Texture2D
+struct TextureSlot {
+	std::string path;
+	Color fallbackColor;  // 读取失败时的备用颜色
+	int fallbackSize;     // 备用纹理边长
+	Image image;          // 解码结果（上传后释放）
+	Texture2D texture;    // 上传后的纹理
+	bool failed;
+	bool adopted;         // 外部传入的纹理，随槽一起卸载
+	std::atomic<AssetState> state;
+	std::vector<std::weak_ptr<std::function<void()>>> listeners; // 只在主线程访问
+
+	TextureSlot()
+	: fallbackColor(BLUE), fallbackSize(64), failed(false), adopted(false), state(AssetState::LOADING) {
+		image = {0};
+		texture = {0};
+	}
+
+	~TextureSlot() {
+		if (adopted && texture.id != 0) {
+			UnloadTexture(texture);
+		}
+	}
+};
+
+/// 纹理句柄：资源就绪前 Get() 返回占位纹理，绘制代码无需等待
+class TextureHandle {
+private:
+	std::shared_ptr<TextureSlot> slot;
+	std::vector<std::shared_ptr<std::function<void()>>> listeners; // 随句柄销毁，避免回调悬空
+
+public:
+	TextureHandle() = default;
+	explicit TextureHandle(std::shared_ptr<TextureSlot> s) : slot(std::move(s)) {}
+
+	bool IsValid() const { return slot != nullptr; }
+	bool IsReady() const { return slot && slot->state.load() != AssetState::LOADING; }
+	bool IsFailed() const { return slot && slot->state.load() == AssetState::FAILED; }
+
+	Texture2D Get() const;
+
+	// 纹理上传完成后在主线程回调（已就绪则立即调用）；可以登记多个回调
+	void OnReady(std::function<void()> callback);
+
+	void Reset() {
+		slot.reset();
+		listeners.clear();
+	}
+};
+
+// 加载器状态（队列由 assetMutex 保护，其余只在主线程访问）
+static std::map<std::string, std::shared_ptr<TextureSlot>> assetCache;
+static std::vector<std::weak_ptr<TextureSlot>> assetAdopted; // AdoptTexture 的槽，不在缓存里，关闭时统一卸载
+static std::deque<std::shared_ptr<TextureSlot>> assetDecodeQueue;
+static std::deque<std::shared_ptr<TextureSlot>> assetUploadQueue;
+static std::mutex assetMutex;
+static std::condition_variable assetCond;
+static std::condition_variable assetDecoded; // 工作线程放入上传队列时通知（同步等待用）
+static std::vector<std::thread> assetWorkers;
+static bool assetStopping = false;
+static Texture2D assetPlaceholder = {0};
+
+Texture2D TextureHandle::Get() const {
+	if (slot && slot->state.load() != AssetState::LOADING) {
+		return slot->texture;
+	}
+	return assetPlaceholder;
+}
+
+void TextureHandle::OnReady(std::function<void()> callback) {
+	if (!slot) return;
+	if (IsReady()) {
+		callback();
+		return;
+	}
+	listeners.push_back(std::make_shared<std::function<void()>>(std::move(callback)));
+	slot->listeners.push_back(listeners.back());
+}
+
+/// 工作线程：只做读取（资源包或磁盘）和 PNG 解码，不碰 OpenGL
+void AssetWorkerLoop() {
+	while (true) {
+		std::shared_ptr<TextureSlot> slot;
+		{
+			std::unique_lock<std::mutex> lock(assetMutex);
+			assetCond.wait(lock, [] { return assetStopping || !assetDecodeQueue.empty(); });
+			if (assetStopping) return;
+			slot = assetDecodeQueue.front();
+			assetDecodeQueue.pop_front();
+		}
+
+		Image image = {0};
+		if (!slot->path.empty()) {
+			image = LoadAssetImage(slot->path);
+		}
+		if (image.data == nullptr) {
+			image = GenImageColor(slot->fallbackSize, slot->fallbackSize, slot->fallbackColor);
+			slot->failed = true;
+		}
+		slot->image = image;
+
+		{
+			std::lock_guard<std::mutex> lock(assetMutex);
+			assetUploadQueue.push_back(slot);
+		}
+		assetDecoded.notify_one();
+	}
+}
+
+/// 初始化资源加载器（InitWindow 之后调用；首次请求资源时也会自动调用）
+bool InitAssetLoader(int workerCount = 2) {
+	if (assetPlaceholder.id == 0) {
+		Image checked = GenImageChecked(64, 64, 16, 16, LIGHTGRAY, GRAY);
+		assetPlaceholder = LoadTextureFromImage(checked);
+		UnloadImage(checked);
+	}
+	if (!assetWorkers.empty()) return true;
+
+	assetStopping = false;
+	if (workerCount < 1) workerCount = 1;
+	for (int i = 0; i < workerCount; ++i) {
+		assetWorkers.emplace_back(AssetWorkerLoop);
+	}
+	return assetPlaceholder.id != 0;
+}
+
+/// 卸载资源加载器（CloseWindow 之前调用）
+void UnloadAssetLoader() {
+	{
+		std::lock_guard<std::mutex> lock(assetMutex);
+		assetStopping = true;
+		assetDecodeQueue.clear();
+	}
+	assetCond.notify_all();
+	for (auto& worker : assetWorkers) {
+		worker.join();
+	}
+	assetWorkers.clear();
+
+	for (auto& slot : assetUploadQueue) {
+		UnloadImage(slot->image);
+		slot->image = {0};
+	}
+	assetUploadQueue.clear();
+
+	for (auto& [path, slot] : assetCache) {
+		if (slot->texture.id != 0) {
+			UnloadTexture(slot->texture);
+			slot->texture = {0};
+		}
+	}
+	assetCache.clear();
+
+	// 被包装的纹理可能由全局对象或比窗口活得久的成员持有，不能等到析构时再卸载
+	for (auto& weak : assetAdopted) {
+		if (auto slot = weak.lock()) {
+			if (slot->texture.id != 0) UnloadTexture(slot->texture);
+			slot->texture = {0};
+			slot->adopted = false;
+		}
+	}
+	assetAdopted.clear();
+
+	if (assetPlaceholder.id != 0) {
+		UnloadTexture(assetPlaceholder);
+		assetPlaceholder = {0};
+	}
+}
+
+/// 异步请求纹理：立即返回句柄，同一路径共享同一份纹理
+TextureHandle RequestTexture(const std::string& path, Color fallbackColor = BLUE, int fallbackSize = 64) {
+	auto it = assetCache.find(path);
+	if (it != assetCache.end()) {
+		return TextureHandle(it->second);
+	}
+
+	InitAssetLoader();
+	AllowFrameAllocations(); // 新资源第一次请求
+
+	auto slot = std::make_shared<TextureSlot>();
+	slot->path = path;
+	slot->fallbackColor = fallbackColor;
+	slot->fallbackSize = fallbackSize;
+	assetCache[path] = slot;
+
+	{
+		std::lock_guard<std::mutex> lock(assetMutex);
+		assetDecodeQueue.push_back(slot);
+	}
+	assetCond.notify_one();
+	return TextureHandle(slot);
+}
+
+/// 把已有纹理包装成句柄，最后一个句柄销毁时卸载；UnloadAssetLoader 时还没销毁的一并卸载
+TextureHandle AdoptTexture(Texture2D texture) {
+	auto slot = std::make_shared<TextureSlot>();
+	slot->texture = texture;
+	slot->adopted = true;
+	slot->state = AssetState::READY;
+	// 顺便清掉已经卸载的槽，列表不随调用次数增长
+	assetAdopted.erase(std::remove_if(assetAdopted.begin(), assetAdopted.end(),
+	                                  [](const std::weak_ptr<TextureSlot>& weak) { return weak.expired(); }),
+	                   assetAdopted.end());
+	assetAdopted.push_back(slot);
+	return TextureHandle(slot);
+}
+
+/// 尚未就绪的资源数量（可用于加载提示）
+int GetPendingAssetCount() {
+	int pending = 0;
+	for (const auto& [path, slot] : assetCache) {
+		if (slot->state.load() == AssetState::LOADING) ++pending;
+	}
+	return pending;
+}
+
+/// 上传队列里的下一张图片并通知等待者，队列为空时返回 false
+static bool UploadNextAsset() {
+	std::shared_ptr<TextureSlot> slot;
+	{
+		std::lock_guard<std::mutex> lock(assetMutex);
+		if (assetUploadQueue.empty()) return false;
+		slot = assetUploadQueue.front();
+		assetUploadQueue.pop_front();
+	}
+
+	slot->texture = LoadTextureFromImage(slot->image);
+	UnloadImage(slot->image);
+	slot->image = {0};
+	slot->state = slot->failed ? AssetState::FAILED : AssetState::READY;
+
+	for (auto& weak : slot->listeners) {
+		if (auto callback = weak.lock()) {
+			(*callback)();
+		}
+	}
+	slot->listeners.clear();
+	return true;
+}
+
+/// 等所有请求过的纹理解码并上传完（包括回调里新请求的）
+void FinishPendingAssets() {
+	PROFILE_SCOPE("asset finish");
+	while (GetPendingAssetCount() > 0) {
+		{
+			std::unique_lock<std::mutex> lock(assetMutex);
+			assetDecoded.wait(lock, [] { return !assetUploadQueue.empty() || assetWorkers.empty(); });
+			if (assetUploadQueue.empty()) return; // 加载器已卸载
+		}
+		while (UploadNextAsset()) {}
+	}
+}
+
+/// 每帧在主线程调用：在时间预算内把解码好的图片上传到显存（至少上传一张）。
+/// 录制/回放时改为等待全部完成：纹理就绪才设置的碰撞箱（脚部、texture_bounds）和寻路阻挡
+/// 必须在同一个 tick 生效，不能取决于解码快慢
+void UpdateAssetLoader(double budgetSeconds = 0.002) {
+	if (IsInputDeterministic()) {
+		FinishPendingAssets();
+		return;
+	}
+	PROFILE_SCOPE("asset upload");
+	double start = GetTime();
+	while (UploadNextAsset() && GetTime() - start < budgetSeconds) {}
+}
+
+/// 卸载已经没有句柄引用的纹理（流式区域卸载后调用），返回卸载数量
+int ReleaseUnusedTextures() {
+	int released = 0;
+	for (auto it = assetCache.begin(); it != assetCache.end();) {
+		const auto& slot = it->second;
+		// 只剩缓存自己持有；加载中的槽还被队列或工作线程引用，不会进入这里
+		if (slot.use_count() == 1 && slot->state.load() != AssetState::LOADING) {
+			if (slot->texture.id != 0) {
+				UnloadTexture(slot->texture);
+			}
+			it = assetCache.erase(it);
+			++released;
+		} else {
+			++it;
+		}
+	}
+	return released;
+}
+
+#endif // ASSET_H
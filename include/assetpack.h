@@ -0,0 +1,309 @@
+#ifndef ASSETPACK_H
+#define ASSETPACK_H
+
+#include "raylib.h"
+#include <string>
+#include <cstring>
+#include <cstdint>
+
+#if defined(_WIN32)
+	// 只取文件映射相关的 API，避免与 raylib 的 Rectangle/CloseWindow/DrawText 等冲突
+	#ifndef WIN32_LEAN_AND_MEAN
+	#define WIN32_LEAN_AND_MEAN
+	#endif
+	#ifndef NOGDI
+	#define NOGDI
+	#endif
+	#ifndef NOUSER
+	#define NOUSER
+	#endif
+	#include <windows.h>
+	#undef near
+	#undef far
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+// ==================== 资源包格式 ====================
+//
+// [PackHeader]
+// [PackEntry * entryCount]   按路径字节序排序，可二分查找
+// [路径字符串表]
+// [数据区]                   每个条目按 alignment 对齐
+//
+// 所有整数均为小端序。
+
+static const char PACK_MAGIC[4] = {'N', 'B', 'P', 'K'};
+static const uint32_t PACK_VERSION = 1;
+static const uint32_t PACK_FLAG_DEFLATE = 1u << 0; // 条目经过 DEFLATE 压缩
+
+struct PackHeader {
+	char magic[4];
+	uint32_t version;
+	uint32_t entryCount;
+	uint32_t indexOffset;
+	uint32_t namesOffset;
+	uint32_t namesSize;
+	uint32_t alignment;
+	uint32_t reserved;
+};
+
+struct PackEntry {
+	uint32_t nameOffset; // 相对于字符串表
+	uint32_t nameLength;
+	uint32_t dataOffset; // 相对于文件开头
+	uint32_t storedSize; // 包内大小
+	uint32_t rawSize;    // 解压后大小
+	uint32_t flags;
+};
+
+// ==================== 只读文件映射 ====================
+
+class MappedFile {
+private:
+	const unsigned char* data;
+	size_t size;
+#if defined(_WIN32)
+	HANDLE fileHandle;
+	HANDLE mappingHandle;
+#endif
+
+public:
+	MappedFile() : data(nullptr), size(0) {
+#if defined(_WIN32)
+		fileHandle = INVALID_HANDLE_VALUE;
+		mappingHandle = nullptr;
+#endif
+	}
+	~MappedFile() { Close(); }
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool Open(const char* path);
+	void Close();
+
+	bool IsOpen() const { return data != nullptr; }
+	const unsigned char* Data() const { return data; }
+	size_t Size() const { return size; }
+};
+
+bool MappedFile::Open(const char* path) {
+	Close();
+#if defined(_WIN32)
+	fileHandle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+							 OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0) {
+		Close();
+		return false;
+	}
+	mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mappingHandle == nullptr) {
+		Close();
+		return false;
+	}
+	data = (const unsigned char*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	size = (size_t)fileSize.QuadPart;
+#else
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) return false;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0) {
+		close(fd);
+		return false;
+	}
+	void* mapped = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd); // 映射建立后即可关闭文件描述符
+	if (mapped == MAP_FAILED) return false;
+
+	data = (const unsigned char*)mapped;
+	size = (size_t)st.st_size;
+#endif
+	if (data == nullptr) {
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void MappedFile::Close() {
+#if defined(_WIN32)
+	if (data) UnmapViewOfFile(data);
+	if (mappingHandle) CloseHandle(mappingHandle);
+	if (fileHandle != INVALID_HANDLE_VALUE) CloseHandle(fileHandle);
+	mappingHandle = nullptr;
+	fileHandle = INVALID_HANDLE_VALUE;
+#else
+	if (data) munmap((void*)data, size);
+#endif
+	data = nullptr;
+	size = 0;
+}
+
+// ==================== 资源包 ====================
+
+/// 从资源包中取出的数据：未压缩条目直接指向映射内存，压缩条目指向解压缓冲区
+struct PackData {
+	const unsigned char* data;
+	int size;
+	unsigned char* owned; // 非空时需调用 UnloadPackData 释放
+};
+
+class AssetPack {
+private:
+	MappedFile file;
+	const PackHeader* header;
+	const PackEntry* entries;
+	const char* names;
+
+	int CompareName(const PackEntry& entry, const char* name, size_t length) const;
+
+public:
+	AssetPack() : header(nullptr), entries(nullptr), names(nullptr) {}
+
+	bool Open(const char* path);
+	void Close();
+	bool IsOpen() const { return header != nullptr; }
+
+	const PackEntry* Find(const std::string& path) const;
+	bool Contains(const std::string& path) const { return Find(path) != nullptr; }
+	PackData Load(const std::string& path) const;
+	int Count() const { return header ? (int)header->entryCount : 0; }
+};
+
+bool AssetPack::Open(const char* path) {
+	Close();
+	if (!file.Open(path)) return false;
+
+	const unsigned char* base = file.Data();
+	size_t size = file.Size();
+	if (size < sizeof(PackHeader)) {
+		Close();
+		return false;
+	}
+
+	const PackHeader* h = (const PackHeader*)base;
+	uint64_t indexEnd = (uint64_t)h->indexOffset + (uint64_t)h->entryCount * sizeof(PackEntry);
+	uint64_t namesEnd = (uint64_t)h->namesOffset + h->namesSize;
+	if (memcmp(h->magic, PACK_MAGIC, 4) != 0 || h->version != PACK_VERSION ||
+		indexEnd > size || namesEnd > size) {
+		TraceLog(LOG_WARNING, "PACK: [%s] 不是有效的资源包", path);
+		Close();
+		return false;
+	}
+
+	// 名字区间在二分查找时直接读取，打开时逐条检查一次，截断或损坏的包整个拒绝
+	const PackEntry* index = (const PackEntry*)(base + h->indexOffset);
+	for (uint32_t i = 0; i < h->entryCount; ++i) {
+		if ((uint64_t)index[i].nameOffset + index[i].nameLength > h->namesSize) {
+			TraceLog(LOG_WARNING, "PACK: [%s] 第 %d 个条目的名字超出名字区", path, (int)i);
+			Close();
+			return false;
+		}
+	}
+
+	header = h;
+	entries = index;
+	names = (const char*)(base + h->namesOffset);
+	TraceLog(LOG_INFO, "PACK: [%s] 已映射 %d 个资源", path, (int)h->entryCount);
+	return true;
+}
+
+void AssetPack::Close() {
+	file.Close();
+	header = nullptr;
+	entries = nullptr;
+	names = nullptr;
+}
+
+int AssetPack::CompareName(const PackEntry& entry, const char* name, size_t length) const {
+	size_t common = entry.nameLength < length ? entry.nameLength : length;
+	int result = memcmp(names + entry.nameOffset, name, common);
+	if (result != 0) return result;
+	if (entry.nameLength == length) return 0;
+	return entry.nameLength < length ? -1 : 1;
+}
+
+const PackEntry* AssetPack::Find(const std::string& path) const {
+	if (!header) return nullptr;
+
+	// 包内路径统一使用 '/' 分隔
+	if (path.find('\\') != std::string::npos) {
+		std::string normalized = path;
+		for (auto& c : normalized) {
+			if (c == '\\') c = '/';
+		}
+		return Find(normalized);
+	}
+
+	// 索引已排序，二分查找
+	int lo = 0;
+	int hi = (int)header->entryCount - 1;
+	while (lo <= hi) {
+		int mid = lo + (hi - lo) / 2;
+		int cmp = CompareName(entries[mid], path.data(), path.size());
+		if (cmp == 0) return &entries[mid];
+		if (cmp < 0) lo = mid + 1;
+		else hi = mid - 1;
+	}
+	return nullptr;
+}
+
+PackData AssetPack::Load(const std::string& path) const {
+	PackData result = {nullptr, 0, nullptr};
+	const PackEntry* entry = Find(path);
+	if (!entry || (uint64_t)entry->dataOffset + entry->storedSize > file.Size()) return result;
+
+	const unsigned char* stored = file.Data() + entry->dataOffset;
+	if (entry->flags & PACK_FLAG_DEFLATE) {
+		int rawSize = 0;
+		result.owned = DecompressData(stored, (int)entry->storedSize, &rawSize);
+		result.data = result.owned;
+		result.size = rawSize;
+	} else {
+		result.data = stored;
+		result.size = (int)entry->storedSize;
+	}
+	return result;
+}
+
+void UnloadPackData(PackData& packData) {
+	if (packData.owned) {
+		MemFree(packData.owned);
+	}
+	packData = {nullptr, 0, nullptr};
+}
+
+// 全局资源包（启动时挂载一次，之后只读，可被多个线程同时访问）
+static AssetPack assetPack;
+
+/// 挂载资源包，找不到时各加载函数退回读取散文件
+bool InitAssetPack(const char* packPath) {
+	return assetPack.Open(packPath);
+}
+
+/// 卸载资源包（所有资源卸载之后调用）
+void UnloadAssetPack() {
+	assetPack.Close();
+}
+
+/// 优先从资源包解码图片，否则读取磁盘文件（线程安全，可在工作线程调用）
+Image LoadAssetImage(const std::string& path) {
+	PackData packed = assetPack.Load(path);
+	if (packed.data) {
+		const char* ext = GetFileExtension(path.c_str());
+		Image image = LoadImageFromMemory(ext ? ext : ".png", packed.data, packed.size);
+		UnloadPackData(packed);
+		return image;
+	}
+	return LoadImage(path.c_str());
+}
+
+#endif // ASSETPACK_H
@@ -0,0 +1,1729 @@
+#ifndef CHARACTER_H
+#define CHARACTER_H
+
+#include "raylib.h"
+#include "nbsfont.h"
+#include "asset.h"
+#include "snapshot.h"
+#include "input.h"
+#include "framemem.h"
+#include "animation.h"
+#include "renderscale.h"
+#include <string>
+#include <vector>
+#include <cmath>
+#include <map>
+#include <unordered_map>
+#include <memory>
+#include <functional>
+#include <algorithm>
+#include <cstdint>
+
+// 角色方向枚举
+enum class Direction {
+	DOWN,
+	LEFT,
+	RIGHT,
+	UP
+};
+
+// 动画状态枚举
+enum class AnimationState {
+	IDLE,
+	WALKING
+};
+
+// 模拟 LOD 的更新档位（按与关注点的距离划分）
+enum class UpdateTier {
+	FULL,    // 每帧更新
+	REDUCED, // 每隔几帧更新一次，传入累计的时间
+	DORMANT  // 不更新，醒来时补上睡眠期间的时间（有上限）
+};
+
+// 碰撞箱组件
+struct CollisionComponent {
+	Rectangle rect;
+	Color debugColor;
+	bool isSolid;
+	std::string name;
+	bool visible; // 是否显示碰撞箱
+	
+	CollisionComponent() 
+	: rect({0, 0, 0, 0}), debugColor(RED), isSolid(true), name(""), visible(true) {}
+	
+	CollisionComponent(const Rectangle& r, const Color& c, bool solid, const std::string& n = "")
+	: rect(r), debugColor(c), isSolid(solid), name(n), visible(true) {}
+};
+
+// 阻挡几何的变化记录，供寻路网格增量重建（navigation.h）
+struct GeometryChanges {
+	std::vector<Rectangle> areas; // 自上次取走以来变化过的区域（世界坐标）
+	bool reset = false;           // 全部清空过，需要整体重建
+	
+	void Add(const Rectangle& area) {
+		if (reset) return; // 反正要整体重建
+		// 没人取走时不无限增长，积累太多就退化为整体重建
+		if (areas.size() >= 256) {
+			Reset();
+			return;
+		}
+		areas.push_back(area);
+	}
+	void Reset() { areas.clear(); reset = true; }
+	// 取走全部记录（与 out 交换，复用两边的容量）
+	void Take(GeometryChanges& out) {
+		out.areas.clear();
+		out.areas.swap(areas);
+		out.reset = reset;
+		reset = false;
+	}
+};
+
+// 实体碰撞箱的均匀网格索引（压缩行存储）：格子 c 里的碰撞箱下标为
+// items[cellStart[c]] .. items[cellStart[c + 1] - 1]，跨格子的碰撞箱在每个格子里各出现一次
+struct BroadphaseGrid {
+	Rectangle bounds = {0, 0, 0, 0}; // 所有被索引碰撞箱的包围盒
+	float cellSize = 128.0f;
+	int cols = 0;                    // 为 0 表示没有索引
+	int rows = 0;
+	std::vector<uint32_t> cellStart; // cols * rows + 1 项
+	std::vector<uint32_t> items;
+};
+
+/// 建立网格索引（场景编译器、CollisionSystem 和 GameObjectSystem 共用）。rectOf(i, rect) 返回第 i 个碰撞箱是否参与索引
+template<typename RectOf>
+void BuildBroadphaseGrid(size_t count, RectOf&& rectOf, float cellSize, BroadphaseGrid& grid) {
+	grid.cols = grid.rows = 0;
+	grid.cellStart.clear();
+	grid.items.clear();
+	
+	bool any = false;
+	float minX = 0, minY = 0, maxX = 0, maxY = 0;
+	Rectangle rect;
+	for (size_t i = 0; i < count; ++i) {
+		if (!rectOf(i, rect)) continue;
+		if (!any) {
+			minX = rect.x;
+			minY = rect.y;
+			maxX = rect.x + rect.width;
+			maxY = rect.y + rect.height;
+			any = true;
+		} else {
+			minX = std::min(minX, rect.x);
+			minY = std::min(minY, rect.y);
+			maxX = std::max(maxX, rect.x + rect.width);
+			maxY = std::max(maxY, rect.y + rect.height);
+		}
+	}
+	if (!any) return;
+	
+	// 格子总数不超过约 100 万，否则加大格子
+	float size = cellSize > 1.0f ? cellSize : 1.0f;
+	while (((maxX - minX) / size + 1) * ((maxY - minY) / size + 1) > (1 << 20)) size *= 2.0f;
+	grid.bounds = {minX, minY, maxX - minX, maxY - minY};
+	grid.cellSize = size;
+	grid.cols = (int)((maxX - minX) / size) + 1;
+	grid.rows = (int)((maxY - minY) / size) + 1;
+	grid.cellStart.assign((size_t)grid.cols * grid.rows + 1, 0);
+	
+	// 两遍：先数每个格子的数量，再填入
+	auto forCells = [&](const Rectangle& box, auto&& visit) {
+		int x0 = (int)((box.x - minX) / size);
+		int y0 = (int)((box.y - minY) / size);
+		int x1 = std::min(grid.cols - 1, (int)((box.x + box.width - minX) / size));
+		int y1 = std::min(grid.rows - 1, (int)((box.y + box.height - minY) / size));
+		for (int y = y0; y <= y1; ++y) {
+			for (int x = x0; x <= x1; ++x) visit(y * grid.cols + x);
+		}
+	};
+	for (size_t i = 0; i < count; ++i) {
+		if (rectOf(i, rect)) forCells(rect, [&](int cell) { ++grid.cellStart[cell + 1]; });
+	}
+	for (size_t c = 1; c < grid.cellStart.size(); ++c) grid.cellStart[c] += grid.cellStart[c - 1];
+	grid.items.resize(grid.cellStart.back());
+	std::vector<uint32_t> fill(grid.cellStart.begin(), grid.cellStart.end() - 1);
+	for (size_t i = 0; i < count; ++i) {
+		if (rectOf(i, rect)) forCells(rect, [&](int cell) { grid.items[fill[cell]++] = (uint32_t)i; });
+	}
+}
+
+/// 查找索引里与 rect 相交的项，每项只交给 visit 一次。rectOf(i) 返回第 i 项的矩形
+template<typename RectOf, typename Visit>
+void QueryBroadphaseGrid(const BroadphaseGrid& grid, const Rectangle& rect, RectOf&& rectOf, Visit&& visit) {
+	const Rectangle& bounds = grid.bounds;
+	if (grid.cols == 0 || rect.x > bounds.x + bounds.width || rect.y > bounds.y + bounds.height ||
+		rect.x + rect.width < bounds.x || rect.y + rect.height < bounds.y) {
+		return;
+	}
+	int x0 = std::max(0, (int)((rect.x - bounds.x) / grid.cellSize));
+	int y0 = std::max(0, (int)((rect.y - bounds.y) / grid.cellSize));
+	int x1 = std::min(grid.cols - 1, (int)((rect.x + rect.width - bounds.x) / grid.cellSize));
+	int y1 = std::min(grid.rows - 1, (int)((rect.y + rect.height - bounds.y) / grid.cellSize));
+	for (int y = y0; y <= y1; ++y) {
+		for (int x = x0; x <= x1; ++x) {
+			int cell = y * grid.cols + x;
+			for (uint32_t k = grid.cellStart[cell]; k < grid.cellStart[cell + 1]; ++k) {
+				uint32_t item = grid.items[k];
+				const Rectangle& box = rectOf(item);
+				// 跨格子的项只在它与查询范围重叠的第一个格子里处理
+				if (x != std::max(x0, (int)((box.x - bounds.x) / grid.cellSize)) ||
+					y != std::max(y0, (int)((box.y - bounds.y) / grid.cellSize))) {
+					continue;
+				}
+				if (CheckCollisionRecs(rect, box)) visit(item);
+			}
+		}
+	}
+}
+
+// ==================== 标签 ====================
+//
+// 物体的类别用驻留的小整数标签表示（"coin"、"enemy" ...），一个物体可以有多个标签。
+// GameObjectSystem 为每个标签维护成员列表，增删物体和标签时同步更新，
+// 按类别查询只遍历该标签的成员，不再对所有物体的 id 做子串匹配。
+
+using TagId = uint16_t;
+static const TagId NO_TAG = 0xFFFF;
+
+static std::vector<std::string> tagNames;
+static std::unordered_map<std::string, TagId> tagIndex;
+
+/// 取名字对应的标签，第一次出现时登记
+TagId InternTag(const std::string& name) {
+	auto it = tagIndex.find(name);
+	if (it != tagIndex.end()) return it->second;
+	if (tagNames.size() >= NO_TAG) {
+		TraceLog(LOG_WARNING, "TAG: 标签数量超过上限，忽略 %s", name.c_str());
+		return NO_TAG;
+	}
+	TagId tag = (TagId)tagNames.size();
+	tagNames.push_back(name);
+	tagIndex.emplace(name, tag);
+	return tag;
+}
+
+/// 查找已登记的标签，没有时返回 NO_TAG（查询用，不会让标签表增长）
+TagId FindTag(const std::string& name) {
+	auto it = tagIndex.find(name);
+	return it != tagIndex.end() ? it->second : NO_TAG;
+}
+
+const std::string& GetTagName(TagId tag) {
+	static const std::string empty;
+	return tag < tagNames.size() ? tagNames[tag] : empty;
+}
+
+class GameObject;
+class GameObjectSystem;
+// GameObjectSystem 中的一项（id, 物体），地址在物体移除前不变
+using ObjectEntry = std::pair<const std::string, std::shared_ptr<GameObject>>;
+
+// 物体基类
+class GameObject {
+protected:
+	std::string id;
+	Vector2 position;
+	bool visible;
+	std::vector<CollisionComponent> collisionComponents;
+	bool collisionEnabled; // 新增：是否启用碰撞检测
+	
+	// 碰撞箱的世界坐标缓存：位置、缩放、原点或碰撞箱改变时置脏，下次查询时重算
+	mutable std::vector<Rectangle> worldRects;
+	mutable Rectangle solidBounds; // 所有实体碰撞箱的包围盒
+	mutable bool hasSolid;
+	mutable bool boundsDirty;
+	
+	void MarkBoundsDirty() { boundsDirty = true; }
+	void RefreshWorldRects() const;
+	// 实体碰撞箱改变前后各调用一次：已加入系统时把旧的和新的范围都记为几何变化
+	void RecordGeometryChange() const;
+	
+public:
+	GameObject(const std::string& objId = "") : 
+	id(objId), position({0, 0}), visible(true), collisionEnabled(true),
+	solidBounds({0, 0, 0, 0}), hasSolid(false), boundsDirty(true) {}
+	virtual ~GameObject() = default;
+	
+	virtual void Update(float deltaTime) {}
+	virtual void Draw() const = 0;
+	virtual void DrawDebug() const {}
+	
+	// 碰撞检测
+	virtual bool CheckCollision(const Rectangle& other) const;
+	virtual bool CheckCollision(const GameObject& other) const;
+	
+	// 获取和设置方法
+	std::string GetId() const { return id; }
+	void SetId(const std::string& newId) { id = newId; }
+	
+	Vector2 GetPosition() const { return position; }
+	virtual void SetPosition(const Vector2& newPos);
+	
+	bool IsVisible() const { return visible; }
+	void SetVisible(bool isVisible) { visible = isVisible; }
+	
+	// 碰撞箱管理
+	void AddCollisionComponent(const CollisionComponent& collision);
+	void AddCollisionComponent(const Rectangle& rect, const Color& color, 
+							   bool isSolid, const std::string& name = "");
+	virtual void ClearCollisionComponents();
+	const std::vector<CollisionComponent>& GetCollisionComponents() const { return collisionComponents; }
+	// 与 GetCollisionComponents 一一对应的世界坐标矩形
+	const std::vector<Rectangle>& GetWorldCollisionRects() const;
+	// 所有实体碰撞箱的包围盒，没有实体碰撞箱时返回 false
+	bool GetSolidBounds(Rectangle& bounds) const;
+	void SetCollisionVisible(bool visible);
+	
+	bool IsCollisionEnabled() const { return collisionEnabled; }
+	void SetCollisionEnabled(bool enabled) { collisionEnabled = enabled; }
+	
+	// 获取物体边界（用于粗略碰撞检测）
+	virtual Rectangle GetBounds() const = 0;
+	
+	// 存档：只保存运行时会变化的状态，贴图和碰撞箱由场景代码重建
+	virtual void SaveState(SnapshotWriter& out) const;
+	virtual bool LoadState(SnapshotReader& in);
+	
+	UpdateTier GetUpdateTier() const { return lodTier; }
+	
+	// 标签：已加入 GameObjectSystem 的物体增删标签时同步更新系统的成员列表
+	void AddTag(TagId tag);
+	void AddTag(const std::string& name) { AddTag(InternTag(name)); }
+	void RemoveTag(TagId tag);
+	bool HasTag(TagId tag) const;
+	size_t GetTagCount() const { return tags.size(); }
+	TagId GetTag(size_t index) const { return tags[index].tag; }
+	
+private:
+	friend class GameObjectSystem;
+	
+	// 标签及其在系统成员列表中的下标（移除时与末尾交换，O(1)）
+	struct TagSlot {
+		TagId tag;
+		uint32_t slot;
+	};
+	std::vector<TagSlot> tags;
+	GameObjectSystem* ownerSystem = nullptr; // 所属的系统（一个物体同时只能属于一个系统）
+	const ObjectEntry* ownerEntry = nullptr;
+	
+	// 模拟 LOD 的簿记，由 GameObjectSystem 维护
+	int64_t lodCell = 0;          // 所在的空间索引格子
+	bool lodIndexed = false;
+	bool lodAwake = false;
+	UpdateTier lodTier = UpdateTier::FULL;
+	uint8_t lodPhase = 0;         // 降频更新错开的相位
+	uint32_t lodSeenFrame = 0;    // 最近一次在关注范围内的帧
+	float lodPendingDelta = 0.0f; // 还没交给 Update 的时间
+	double lodSleepClock = 0.0;   // 入睡时的 LOD 时钟
+};
+
+// 物体管理系统
+class GameObjectSystem {
+private:
+	std::map<std::string, std::shared_ptr<GameObject>> objects;
+	std::string characterId; // 存储角色ID
+	GeometryChanges changes; // 加入/移除带实体碰撞箱的物体时记录
+	
+	// 模拟 LOD：物体按位置放进均匀网格，每帧只访问关注点附近格子里的物体，
+	// 醒着的物体列表逐帧对比得出入睡的物体，远处的物体完全不被遍历
+	bool lodEnabled = false;
+	float lodFullRadius = 0.0f;
+	float lodReducedRadius = 0.0f;
+	int lodReducedInterval = 4;
+	float lodCellSize = 256.0f;
+	float lodMaxCatchUp = 0.5f; // 醒来时最多补多少秒
+	Vector2 lodFocus = {0, 0};
+	uint32_t lodFrame = 0;
+	double lodClock = 0.0;
+	uint8_t lodNextPhase = 0;
+	std::unordered_map<int64_t, std::vector<GameObject*>> lodCells;
+	std::vector<GameObject*> lodAwakeList; // 上一帧醒着的物体
+	std::vector<GameObject*> lodNextAwake;
+	
+	// 标签成员列表，按 TagId 下标
+	std::vector<std::vector<const ObjectEntry*>> tagMembers;
+	
+	friend class GameObject;
+	
+	void TagInsert(GameObject* object, size_t index) {
+		TagId tag = object->tags[index].tag;
+		if (tagMembers.size() <= tag) tagMembers.resize((size_t)tag + 1);
+		object->tags[index].slot = (uint32_t)tagMembers[tag].size();
+		tagMembers[tag].push_back(object->ownerEntry);
+	}
+	
+	void TagErase(GameObject* object, size_t index) {
+		TagId tag = object->tags[index].tag;
+		uint32_t slot = object->tags[index].slot;
+		std::vector<const ObjectEntry*>& members = tagMembers[tag];
+		const ObjectEntry* last = members.back();
+		members[slot] = last;
+		members.pop_back();
+		if (last->second.get() != object) {
+			for (auto& moved : last->second->tags) {
+				if (moved.tag == tag) moved.slot = slot;
+			}
+		}
+	}
+	
+	void TagAttach(const ObjectEntry* entry) {
+		GameObject* object = entry->second.get();
+		object->ownerSystem = this;
+		object->ownerEntry = entry;
+		for (size_t i = 0; i < object->tags.size(); ++i) TagInsert(object, i);
+	}
+	
+	void TagDetach(GameObject* object) {
+		if (object->ownerSystem != this) return;
+		for (size_t i = 0; i < object->tags.size(); ++i) TagErase(object, i);
+		object->ownerSystem = nullptr;
+		object->ownerEntry = nullptr;
+	}
+	
+	void RecordChange(const GameObject& object) {
+		staticDirty = true;
+		Rectangle bounds;
+		if (object.GetSolidBounds(bounds)) changes.Add(bounds);
+	}
+	
+	// 静态阻挡（ImageObject 的实体碰撞箱）的网格索引，供寻路按区域查询；
+	// 记录几何变化时置脏，下次查询时重建
+	struct StaticSolid {
+		const GameObject* object;
+		Rectangle rect;
+	};
+	mutable std::vector<StaticSolid> staticSolids;
+	mutable BroadphaseGrid staticGrid;
+	mutable bool staticDirty = true;
+	
+	void EnsureStaticSolids() const;
+	
+	int64_t LodCellOf(Vector2 point) const {
+		int x = (int)std::floor(point.x / lodCellSize);
+		int y = (int)std::floor(point.y / lodCellSize);
+		return (int64_t)(((uint64_t)(uint32_t)x << 32) | (uint32_t)y);
+	}
+	
+	void LodInsert(GameObject* object) {
+		object->lodCell = LodCellOf(object->position);
+		object->lodIndexed = true;
+		object->lodPhase = (uint8_t)(lodNextPhase++ % lodReducedInterval);
+		object->lodSleepClock = lodClock; // 加入后第一次醒来不补加入之前的时间
+		lodCells[object->lodCell].push_back(object);
+	}
+	
+	void LodErase(GameObject* object) {
+		if (!object->lodIndexed) return;
+		auto cell = lodCells.find(object->lodCell);
+		if (cell != lodCells.end()) {
+			std::vector<GameObject*>& list = cell->second;
+			auto it = std::find(list.begin(), list.end(), object);
+			if (it != list.end()) {
+				*it = list.back();
+				list.pop_back();
+			}
+			if (list.empty()) lodCells.erase(cell);
+		}
+		object->lodIndexed = false;
+		if (object->lodAwake) {
+			lodAwakeList.erase(std::remove(lodAwakeList.begin(), lodAwakeList.end(), object), lodAwakeList.end());
+			object->lodAwake = false;
+		}
+	}
+	
+	// 物体移动到别的格子时挪过去
+	void LodReindex(GameObject* object) {
+		if (LodCellOf(object->position) == object->lodCell) return;
+		bool awake = object->lodAwake;
+		object->lodAwake = false; // 不从醒着的列表里删
+		uint8_t phase = object->lodPhase;
+		double sleepClock = object->lodSleepClock;
+		LodErase(object);
+		LodInsert(object);
+		object->lodPhase = phase;
+		object->lodSleepClock = sleepClock;
+		object->lodAwake = awake;
+	}
+	
+	void LodMoved(GameObject* object) {
+		if (lodEnabled && object->lodIndexed) LodReindex(object);
+	}
+	
+	void UpdateAllLod(float deltaTime);
+	
+public:
+	GameObjectSystem() = default;
+	// 物体里保存着指回系统的指针，不能复制
+	GameObjectSystem(const GameObjectSystem&) = delete;
+	GameObjectSystem& operator=(const GameObjectSystem&) = delete;
+	~GameObjectSystem() { Clear(); }
+	
+	void AddObject(const std::string& id, std::shared_ptr<GameObject> object) {
+		auto it = objects.find(id);
+		if (it != objects.end()) {
+			RecordChange(*it->second);
+			if (lodEnabled) LodErase(it->second.get());
+			TagDetach(it->second.get());
+		}
+		RecordChange(*object);
+		if (lodEnabled) LodInsert(object.get());
+		it = objects.insert_or_assign(id, object).first;
+		TagAttach(&*it);
+	}
+	
+	// 设置角色ID
+	void SetCharacterId(const std::string& id) {
+		characterId = id;
+	}
+	
+	bool RemoveObject(const std::string& id) {
+		auto it = objects.find(id);
+		if (it == objects.end()) return false;
+		RecordChange(*it->second);
+		if (lodEnabled) LodErase(it->second.get());
+		TagDetach(it->second.get());
+		objects.erase(it);
+		return true;
+	}
+	
+	// 非 const 版本
+	std::shared_ptr<GameObject> GetObject(const std::string& id) {
+		auto it = objects.find(id);
+		if (it != objects.end()) {
+			return it->second;
+		}
+		return nullptr;
+	}
+	
+	// const 版本
+	std::shared_ptr<const GameObject> GetObject(const std::string& id) const {
+		auto it = objects.find(id);
+		if (it != objects.end()) {
+			return it->second;
+		}
+		return nullptr;
+	}
+	
+	// 只在本帧内使用时用这个，不复制 shared_ptr
+	GameObject* FindObject(const std::string& id) const {
+		auto it = objects.find(id);
+		return it != objects.end() ? it->second.get() : nullptr;
+	}
+	
+	void UpdateAll(float deltaTime) {
+		PROFILE_SCOPE("objects update");
+		if (lodEnabled) {
+			UpdateAllLod(deltaTime);
+			return;
+		}
+		for (auto& [id, obj] : objects) {
+			if (obj->IsVisible()) {
+				obj->Update(deltaTime);
+			}
+		}
+	}
+	
+	// 开启模拟 LOD：距关注点 fullRadius 内每帧更新，reducedRadius 内每 reducedInterval 帧
+	// 更新一次，更远的休眠。cellSize 为空间索引的格子边长
+	void EnableSimulationLod(float fullRadius, float reducedRadius, int reducedInterval = 4, float cellSize = 256.0f) {
+		lodFullRadius = fullRadius;
+		lodReducedRadius = reducedRadius > fullRadius ? reducedRadius : fullRadius;
+		lodReducedInterval = reducedInterval > 1 ? reducedInterval : 1;
+		lodCellSize = cellSize > 1.0f ? cellSize : 1.0f;
+		lodCells.clear();
+		lodAwakeList.clear();
+		lodEnabled = true;
+		for (auto& [id, obj] : objects) {
+			obj->lodAwake = false;
+			LodInsert(obj.get());
+		}
+	}
+	
+	void DisableSimulationLod() {
+		lodEnabled = false;
+		lodCells.clear();
+		lodAwakeList.clear();
+		for (auto& [id, obj] : objects) {
+			obj->lodIndexed = false;
+			obj->lodAwake = false;
+			obj->lodTier = UpdateTier::FULL;
+		}
+	}
+	
+	// 每帧 UpdateAll 之前设置，一般是相机的目标点
+	void SetLodFocus(Vector2 focus) { lodFocus = focus; }
+	
+	// SetPosition 会自动换格子；绕过它直接改了位置之后调用，重建空间索引
+	void RefreshLodIndex() {
+		if (lodEnabled) EnableSimulationLod(lodFullRadius, lodReducedRadius, lodReducedInterval, lodCellSize);
+	}
+	
+	int GetAwakeObjectCount() const { return lodEnabled ? (int)lodAwakeList.size() : (int)objects.size(); }
+	
+	void DrawAll() const {
+		PROFILE_SCOPE("objects draw");
+		// 先绘制所有非角色物体
+		for (const auto& [id, obj] : objects) {
+			if (obj->IsVisible() && id != characterId) {
+				obj->Draw();
+			}
+		}
+		
+		// 最后绘制角色（确保在最上层）
+		if (!characterId.empty()) {
+			auto it = objects.find(characterId);
+			if (it != objects.end() && it->second->IsVisible()) {
+				it->second->Draw();
+			}
+		}
+	}
+	
+	void DrawAllDebug() const {
+		// 先绘制所有非角色物体的调试信息
+		for (const auto& [id, obj] : objects) {
+			if (obj->IsVisible() && id != characterId) {
+				obj->DrawDebug();
+			}
+		}
+		
+		// 最后绘制角色的调试信息（确保在最上层）
+		if (!characterId.empty()) {
+			auto it = objects.find(characterId);
+			if (it != objects.end() && it->second->IsVisible()) {
+				it->second->DrawDebug();
+			}
+		}
+	}
+	
+	// 碰撞检测
+	bool CheckCollision(const std::string& id, const Rectangle& rect) const {
+		const GameObject* obj = FindObject(id);
+		if (obj && obj->IsVisible() && obj->IsCollisionEnabled()) {
+			return obj->CheckCollision(rect);
+		}
+		return false;
+	}
+	
+	bool CheckCollision(const std::string& id1, const std::string& id2) const {
+		const GameObject* obj1 = FindObject(id1);
+		const GameObject* obj2 = FindObject(id2);
+		if (obj1 && obj2 && obj1->IsVisible() && obj1->IsCollisionEnabled() && 
+			obj2->IsVisible() && obj2->IsCollisionEnabled()) {
+			return obj1->CheckCollision(*obj2);
+		}
+		return false;
+	}
+	
+	// 检查与所有物体的碰撞
+	bool CheckCollisionWithAll(const std::string& id, 
+							   std::function<void(const std::string&)> callback = nullptr) const {
+		const GameObject* targetObj = FindObject(id);
+		if (!targetObj || !targetObj->IsVisible() || !targetObj->IsCollisionEnabled()) {
+			return false;
+		}
+		
+		bool collisionFound = false;
+		for (const auto& [otherId, otherObj] : objects) {
+			if (otherId != id && otherObj->IsVisible() && otherObj->IsCollisionEnabled()) {
+				if (targetObj->CheckCollision(*otherObj)) {
+					collisionFound = true;
+					if (callback) {
+						callback(otherId);
+					}
+				}
+			}
+		}
+		return collisionFound;
+	}
+	
+	// 检查与带某个标签的物体的碰撞，只遍历该标签的成员
+	bool CheckCollisionWithTag(const std::string& id, TagId tag,
+							   std::function<void(const std::string&)> callback = nullptr) const {
+		const GameObject* targetObj = FindObject(id);
+		if (!targetObj || !targetObj->IsVisible() || !targetObj->IsCollisionEnabled()) {
+			return false;
+		}
+		
+		bool collisionFound = false;
+		for (const ObjectEntry* entry : GetObjectsWithTag(tag)) {
+			const GameObject* otherObj = entry->second.get();
+			if (otherObj != targetObj && otherObj->IsVisible() && otherObj->IsCollisionEnabled()) {
+				if (targetObj->CheckCollision(*otherObj)) {
+					collisionFound = true;
+					if (callback) {
+						callback(entry->first);
+					}
+				}
+			}
+		}
+		return collisionFound;
+	}
+	
+	// 检查特定类型物体的碰撞（type 为标签名）
+	bool CheckCollisionWithType(const std::string& id, const std::string& type,
+								std::function<void(const std::string&)> callback = nullptr) const {
+		return CheckCollisionWithTag(id, FindTag(type), callback);
+	}
+	
+	// 遍历所有对象进行碰撞检测（优化版本）
+	// callback(id1, id2)；模板参数避免每次调用把 lambda 装进 std::function
+	template<typename Callback>
+	void CheckAllCollisions(Callback&& callback) const {
+		PROFILE_SCOPE("objects collision");
+		
+		// 首先收集所有活动的物体（帧内存，不做堆分配）
+		FrameVector<const std::pair<const std::string, std::shared_ptr<GameObject>>*> active;
+		active.reserve(objects.size());
+		for (const auto& entry : objects) {
+			if (entry.second->IsVisible() && entry.second->IsCollisionEnabled()) {
+				active.push_back(&entry);
+			}
+		}
+		
+		// 检查所有活动物体之间的碰撞
+		for (size_t i = 0; i < active.size(); ++i) {
+			const GameObject& obj1 = *active[i]->second;
+			for (size_t j = i + 1; j < active.size(); ++j) {
+				if (obj1.CheckCollision(*active[j]->second)) {
+					callback(active[i]->first, active[j]->first);
+				}
+			}
+		}
+	}
+	
+	// 带某个标签的所有物体（顺序不固定），增删物体或标签后失效
+	const std::vector<const ObjectEntry*>& GetObjectsWithTag(TagId tag) const {
+		static const std::vector<const ObjectEntry*> empty;
+		return tag < tagMembers.size() ? tagMembers[tag] : empty;
+	}
+	
+	// 获取特定类型（标签名）的所有可见物体ID
+	std::vector<std::string> GetObjectIdsByType(const std::string& type) const {
+		std::vector<std::string> result;
+		for (const ObjectEntry* entry : GetObjectsWithTag(FindTag(type))) {
+			if (entry->second->IsVisible()) {
+				result.push_back(entry->first);
+			}
+		}
+		return result;
+	}
+	
+	// 获取所有活动物体的ID
+	std::vector<std::string> GetAllActiveObjectIds() const {
+		std::vector<std::string> result;
+		for (const auto& [id, obj] : objects) {
+			if (obj->IsVisible() && obj->IsCollisionEnabled()) {
+				result.push_back(id);
+			}
+		}
+		return result;
+	}
+	
+	void Clear() {
+		for (auto& [id, obj] : objects) {
+			if (obj->ownerSystem == this) {
+				obj->ownerSystem = nullptr;
+				obj->ownerEntry = nullptr;
+				// 物体可能还被别处持有，之后加入别的系统时不能带着这里的 LOD 簿记
+				obj->lodIndexed = false;
+				obj->lodAwake = false;
+				obj->lodTier = UpdateTier::FULL;
+			}
+		}
+		tagMembers.clear();
+		objects.clear();
+		changes.Reset();
+		staticSolids.clear();
+		staticDirty = true;
+		lodCells.clear();
+		lodAwakeList.clear();
+		lodNextAwake.clear();
+	}
+	
+	size_t Count() const {
+		return objects.size();
+	}
+	
+	// 取走自上次以来的物体增删记录（加入后被移动的物体不在记录里）
+	void TakeChanges(GeometryChanges& out) {
+		changes.Take(out);
+	}
+	
+	// 与 rect 相交的静态阻挡矩形逐个交给 visit（碰撞被禁用的物体跳过）
+	template<typename Visit>
+	void QueryStaticSolids(const Rectangle& rect, Visit&& visit) const {
+		EnsureStaticSolids();
+		QueryBroadphaseGrid(staticGrid, rect, [this](uint32_t i) -> const Rectangle& { return staticSolids[i].rect; },
+			[&](uint32_t i) {
+				if (staticSolids[i].object->IsCollisionEnabled()) visit(staticSolids[i].rect);
+			});
+	}
+	
+	const std::map<std::string, std::shared_ptr<GameObject>>& GetAllObjects() const {
+		return objects;
+	}
+	
+	// 存档：按 id 保存每个物体的状态；读档时跳过当前场景中不存在的 id
+	void SaveState(SnapshotWriter& out) const {
+		out.Write((uint32_t)objects.size());
+		for (const auto& [id, obj] : objects) {
+			out.WriteString(id);
+			out.BeginBlock(SNAP_OBJECT);
+			obj->SaveState(out);
+			out.EndBlock();
+		}
+	}
+	
+	bool LoadState(SnapshotReader& in) {
+		uint32_t count = 0;
+		if (!in.Read(count)) return false;
+		for (uint32_t i = 0; i < count; ++i) {
+			std::string id;
+			uint32_t tag = 0;
+			SnapshotReader block;
+			if (!in.ReadString(id) || !in.NextBlock(tag, block)) return false;
+			
+			auto obj = GetObject(id);
+			if (obj && tag == SNAP_OBJECT) {
+				obj->LoadState(block);
+			}
+		}
+		return true;
+	}
+};
+
+// 图片物体类
+class ImageObject : public GameObject {
+private:
+	TextureHandle texture;
+	float scale;
+	Color tint;
+	Vector2 origin; // 绘制原点
+	int textureBoundsIndex; // 基于纹理的碰撞箱下标，-1 表示已被清除
+	
+public:
+	ImageObject(const std::string& texturePath, const std::string& objId = "")
+	: GameObject(objId), scale(1.0f), tint(WHITE), origin({0, 0}), textureBoundsIndex(0) {
+		// 后台加载纹理（失败时使用蓝色备用纹理）
+		texture = RequestTexture(texturePath, BLUE);
+		
+		// 自动添加基于纹理的碰撞箱（纹理就绪后更新尺寸）
+		textureBoundsIndex = (int)collisionComponents.size();
+		AddCollisionComponent({0, 0, 0, 0}, GREEN, true, "texture_bounds");
+		texture.OnReady([this]() { UpdateCollisionComponents(); });
+	}
+	
+	void Draw() const override {
+		Texture2D tex = texture.Get();
+		if (tex.id != 0 && visible) {
+			Vector2 drawPos = {
+				position.x - origin.x * scale,
+				position.y - origin.y * scale
+			};
+			DrawTextureEx(tex, drawPos, 0.0f, scale, tint);
+		}
+	}
+	
+	void DrawDebug() const override {
+		if (!visible) return;
+		
+		// 绘制碰撞箱
+		const std::vector<Rectangle>& rects = GetWorldCollisionRects();
+		for (size_t i = 0; i < collisionComponents.size(); ++i) {
+			const CollisionComponent& collision = collisionComponents[i];
+			if (collision.visible) {
+				const Rectangle& worldRect = rects[i];
+				
+				if (collision.isSolid) {
+					DrawRectangleRec(worldRect, Fade(collision.debugColor, 0.5f));
+					DrawRectangleLinesEx(worldRect, 2.0f, collision.debugColor);
+				} else {
+					DrawRectangleRec(worldRect, Fade(collision.debugColor, 0.3f));
+					DrawRectangleLinesEx(worldRect, 1.0f, collision.debugColor);
+				}
+				
+				// 绘制碰撞箱名称
+				if (!collision.name.empty()) {
+					DrawTextUTF(collision.name, Vector2{worldRect.x + 5, worldRect.y + 5}, 10, 1, BLACK);
+				}
+			}
+		}
+	}
+	
+	void ClearCollisionComponents() override {
+		GameObject::ClearCollisionComponents();
+		textureBoundsIndex = -1;
+	}
+	
+	// 获取和设置方法
+	Texture2D GetTexture() const { return texture.Get(); }
+	void SetTexture(Texture2D newTexture);
+	
+	float GetScale() const { return scale; }
+	void SetScale(float newScale);
+	
+	Color GetTint() const { return tint; }
+	void SetTint(Color newTint) { tint = newTint; }
+	
+	Vector2 GetOrigin() const { return origin; }
+	void SetOrigin(const Vector2& newOrigin);
+	
+	Rectangle GetBounds() const override {
+		if (!texture.IsReady()) return {position.x, position.y, 0, 0};
+		
+		Texture2D tex = texture.Get();
+		return {
+			position.x - origin.x * scale,
+			position.y - origin.y * scale,
+			tex.width * scale,
+			tex.height * scale
+		};
+	}
+	
+private:
+	void UpdateCollisionComponents();
+};
+
+// 角色类
+class Character : public GameObject {
+private:
+	TextureHandle characterSheet; // 只用来等精灵表就绪后设置碰撞箱
+	float speed;
+	Vector2 oldPosition; // 用于碰撞解决
+	
+	// 动画：帧表和帧时长在共享的片段里，本实例只有一个 Animator
+	Direction currentDirection;
+	AnimationState currentState;
+	std::string sheetPath;
+	SpriteSheetLayout sheetLayout;
+	AnimationClipHandle clip;
+	AnimatorId animator;
+	int feetIndex; // 脚部碰撞箱下标，精灵表就绪前为 -1
+	
+public:
+	Character(const std::string& objId = "");
+	~Character();
+	
+	Character(const Character&) = delete;
+	Character& operator=(const Character&) = delete;
+	
+	bool LoadCharacterSheet(const std::string& texturePath);
+	void UnloadResources();
+	
+	void Update(float deltaTime) override;
+	void Draw() const override;
+	void DrawDebug() const override;
+	
+	void SaveState(SnapshotWriter& out) const override;
+	bool LoadState(SnapshotReader& in) override;
+	
+	// 输入处理
+	void HandleInput();
+	
+	// 碰撞解决
+	void ResolveCollision();
+	void ResolveCollision(const Vector2& oldPosition);
+	
+	// 脚部碰撞箱（世界坐标）
+	Rectangle GetCollisionBox() const;
+	void DrawCollisionDebug() const { DrawDebug(); }
+	
+	// 边界检查
+	void CheckWorldBounds(const Vector2& worldSize);
+	
+	// 获取方法
+	Direction GetDirection() const {
+		return currentDirection;
+	}
+	AnimationState GetState() const {
+		return currentState;
+	}
+	float GetSpeed() const { return speed; }
+	
+	// 设置方法
+	void SetSpeed(float newSpeed) {
+		speed = newSpeed;
+	}
+	void SetAnimationSpeed(float newSpeed);
+	void SetSpriteLayout(int down, int left, int right, int up);
+	
+	Rectangle GetBounds() const override;
+	void ClearCollisionComponents() override;
+	
+private:
+	void UpdateCollisionComponents();
+	void ApplySheetLayout();
+	void ResolveClip();
+};
+
+// 碰撞箱系统
+struct CollisionBox {
+	Rectangle rect;
+	Color color;
+	bool isSolid;
+	std::string name;
+	int owner = 0; // 所属的流式区域，0 表示常驻
+};
+
+class CollisionSystem {
+private:
+	std::vector<CollisionBox> collisionBoxes;
+	GeometryChanges changes; // 实体碰撞箱的增删记录
+	
+	// 碰撞箱增删后置脏，下次查询时重建（碰撞箱很少时直接逐个比较）
+	mutable BroadphaseGrid grid;
+	mutable bool gridDirty = true;
+	float gridCellSize = 128.0f;
+	
+	bool EnsureBroadphase() const;
+	
+public:
+	void AddCollisionBox(const Rectangle& rect, const Color& color, bool isSolid, const std::string& name = "", int owner = 0);
+	void RemoveOwner(int owner); // 移除某个区域的全部碰撞箱
+	bool CheckCollision(const Rectangle& rect) const;
+	void Draw() const;
+	void Clear();
+	
+	const std::vector<CollisionBox>& GetCollisionBoxes() const {
+		return collisionBoxes;
+	}
+	
+	// 取走自上次以来的实体碰撞箱增删记录
+	void TakeChanges(GeometryChanges& out) {
+		changes.Take(out);
+	}
+	
+	void Reserve(size_t count) { collisionBoxes.reserve(count); }
+	void SetBroadphaseCellSize(float cellSize) {
+		gridCellSize = cellSize > 1.0f ? cellSize : 1.0f;
+		gridDirty = true;
+	}
+	// 直接使用预先建好的索引（场景文件），下标必须与当前碰撞箱一致
+	void AdoptBroadphase(BroadphaseGrid&& prebuilt) {
+		grid = std::move(prebuilt);
+		gridCellSize = grid.cellSize;
+		gridDirty = false;
+	}
+	const BroadphaseGrid& GetBroadphase() const {
+		EnsureBroadphase();
+		return grid;
+	}
+	
+	// 与 rect 相交的实体碰撞箱矩形逐个交给 visit（每个只交一次）
+	template<typename Visit>
+	void QuerySolid(const Rectangle& rect, Visit&& visit) const {
+		if (EnsureBroadphase()) {
+			QueryBroadphaseGrid(grid, rect, [this](uint32_t i) -> const Rectangle& { return collisionBoxes[i].rect; },
+				[&](uint32_t i) { visit(collisionBoxes[i].rect); });
+			return;
+		}
+		for (const auto& box : collisionBoxes) {
+			if (box.isSolid && CheckCollisionRecs(rect, box.rect)) visit(box.rect);
+		}
+	}
+};
+
+// 相机系统
+class CameraSystem {
+private:
+	Camera2D camera;
+	Vector2 targetOffset;
+	
+public:
+	CameraSystem();
+	void Update(const Vector2& targetPosition);
+	void BeginMode() const;
+	void EndMode() const;
+	
+	void SetOffset(const Vector2& offset) {
+		targetOffset = offset;
+	}
+	Camera2D GetCamera() const {
+		return camera;
+	}
+	
+	void SetZoom(float zoom) {
+		camera.zoom = zoom;
+	}
+	float GetZoom() const {
+		return camera.zoom;
+	}
+	
+	// 当前可见的世界区域（不考虑旋转）
+	Rectangle GetViewRect() const;
+	
+	// 窗口坐标（如鼠标位置）与世界坐标互换，与动态分辨率的渲染比例无关
+	Vector2 ScreenToWorld(Vector2 screenPosition) const {
+		return GetScreenToWorld2D(screenPosition, camera);
+	}
+	Vector2 WorldToScreen(Vector2 worldPosition) const {
+		return GetWorldToScreen2D(worldPosition, camera);
+	}
+};
+
+// 工具函数
+namespace CharacterUtils {
+	const char* DirectionToString(Direction dir);
+	const char* StateToString(AnimationState state);
+	Vector2 GetMovementVector(Direction dir);
+}
+
+// ==================== GameObject 实现 ====================
+
+void GameObject::RefreshWorldRects() const {
+	worldRects.resize(collisionComponents.size());
+	hasSolid = false;
+	float minX = 0, minY = 0, maxX = 0, maxY = 0;
+	for (size_t i = 0; i < collisionComponents.size(); ++i) {
+		const CollisionComponent& collision = collisionComponents[i];
+		Rectangle& worldRect = worldRects[i];
+		worldRect = collision.rect;
+		worldRect.x += position.x;
+		worldRect.y += position.y;
+		if (!collision.isSolid) continue;
+		
+		if (!hasSolid) {
+			minX = worldRect.x;
+			minY = worldRect.y;
+			maxX = worldRect.x + worldRect.width;
+			maxY = worldRect.y + worldRect.height;
+			hasSolid = true;
+		} else {
+			minX = std::min(minX, worldRect.x);
+			minY = std::min(minY, worldRect.y);
+			maxX = std::max(maxX, worldRect.x + worldRect.width);
+			maxY = std::max(maxY, worldRect.y + worldRect.height);
+		}
+	}
+	solidBounds = {minX, minY, maxX - minX, maxY - minY};
+	boundsDirty = false;
+}
+
+const std::vector<Rectangle>& GameObject::GetWorldCollisionRects() const {
+	if (boundsDirty) RefreshWorldRects();
+	return worldRects;
+}
+
+bool GameObject::GetSolidBounds(Rectangle& bounds) const {
+	if (boundsDirty) RefreshWorldRects();
+	bounds = solidBounds;
+	return hasSolid;
+}
+
+bool GameObject::CheckCollision(const Rectangle& other) const {
+	if (!visible || !collisionEnabled) return false; // 添加碰撞启用检查
+	
+	const std::vector<Rectangle>& rects = GetWorldCollisionRects();
+	// 包围盒不相交时不可能有碰撞箱相交
+	if (!hasSolid || !CheckCollisionRecs(solidBounds, other)) return false;
+	
+	for (size_t i = 0; i < rects.size(); ++i) {
+		if (collisionComponents[i].isSolid && CheckCollisionRecs(rects[i], other)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool GameObject::CheckCollision(const GameObject& other) const {
+	if (!visible || !collisionEnabled || !other.visible || !other.collisionEnabled) 
+		return false; // 添加碰撞启用检查
+	
+	const std::vector<Rectangle>& myRects = GetWorldCollisionRects();
+	const std::vector<Rectangle>& otherRects = other.GetWorldCollisionRects();
+	if (!hasSolid || !other.hasSolid || !CheckCollisionRecs(solidBounds, other.solidBounds)) {
+		return false;
+	}
+	
+	for (size_t i = 0; i < myRects.size(); ++i) {
+		if (!collisionComponents[i].isSolid) continue;
+		// 先和对方的包围盒比较，避免逐个比较对方的碰撞箱
+		if (!CheckCollisionRecs(myRects[i], other.solidBounds)) continue;
+		
+		for (size_t j = 0; j < otherRects.size(); ++j) {
+			if (other.collisionComponents[j].isSolid && CheckCollisionRecs(myRects[i], otherRects[j])) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+void GameObject::SetPosition(const Vector2& newPos) {
+	position = newPos;
+	MarkBoundsDirty();
+	// 被外部挪走（传送、读档）的休眠物体要换到新位置的格子，靠近关注点时才会醒来
+	if (ownerSystem) ownerSystem->LodMoved(this);
+}
+
+void GameObject::AddCollisionComponent(const CollisionComponent& collision) {
+	collisionComponents.push_back(collision);
+	MarkBoundsDirty();
+}
+
+void GameObject::AddCollisionComponent(const Rectangle& rect, const Color& color, 
+									   bool isSolid, const std::string& name) {
+	collisionComponents.emplace_back(rect, color, isSolid, name);
+	MarkBoundsDirty();
+}
+
+void GameObject::ClearCollisionComponents() {
+	collisionComponents.clear();
+	MarkBoundsDirty();
+}
+
+void GameObject::SetCollisionVisible(bool visible) {
+	for (auto& collision : collisionComponents) {
+		collision.visible = visible;
+	}
+}
+
+void GameObject::SaveState(SnapshotWriter& out) const {
+	out.Write(position);
+	out.Write((uint8_t)visible);
+	out.Write((uint8_t)collisionEnabled);
+}
+
+bool GameObject::LoadState(SnapshotReader& in) {
+	Vector2 savedPosition;
+	uint8_t savedVisible = 1;
+	uint8_t savedCollision = 1;
+	if (!in.Read(savedPosition) || !in.Read(savedVisible) || !in.Read(savedCollision)) {
+		return false;
+	}
+	SetPosition(savedPosition);
+	visible = savedVisible != 0;
+	collisionEnabled = savedCollision != 0;
+	return true;
+}
+
+void GameObject::AddTag(TagId tag) {
+	if (tag == NO_TAG || HasTag(tag)) return;
+	tags.push_back({tag, 0});
+	if (ownerSystem) ownerSystem->TagInsert(this, tags.size() - 1);
+}
+
+void GameObject::RemoveTag(TagId tag) {
+	for (size_t i = 0; i < tags.size(); ++i) {
+		if (tags[i].tag != tag) continue;
+		if (ownerSystem) ownerSystem->TagErase(this, i);
+		tags[i] = tags.back();
+		tags.pop_back();
+		return;
+	}
+}
+
+void GameObject::RecordGeometryChange() const {
+	if (ownerSystem) ownerSystem->RecordChange(*this);
+}
+
+bool GameObject::HasTag(TagId tag) const {
+	for (const TagSlot& entry : tags) {
+		if (entry.tag == tag) return true;
+	}
+	return false;
+}
+
+// ==================== GameObjectSystem 实现 ====================
+
+void GameObjectSystem::UpdateAllLod(float deltaTime) {
+	++lodFrame;
+	lodClock += deltaTime;
+	const float full2 = lodFullRadius * lodFullRadius;
+	const float reduced2 = lodReducedRadius * lodReducedRadius;
+	
+	// 1. 只遍历关注范围覆盖的格子
+	lodNextAwake.clear();
+	int minX = (int)std::floor((lodFocus.x - lodReducedRadius) / lodCellSize);
+	int minY = (int)std::floor((lodFocus.y - lodReducedRadius) / lodCellSize);
+	int maxX = (int)std::floor((lodFocus.x + lodReducedRadius) / lodCellSize);
+	int maxY = (int)std::floor((lodFocus.y + lodReducedRadius) / lodCellSize);
+	for (int y = minY; y <= maxY; ++y) {
+		for (int x = minX; x <= maxX; ++x) {
+			auto cell = lodCells.find((int64_t)(((uint64_t)(uint32_t)x << 32) | (uint32_t)y));
+			if (cell == lodCells.end()) continue;
+			for (GameObject* obj : cell->second) {
+				float dx = obj->position.x - lodFocus.x;
+				float dy = obj->position.y - lodFocus.y;
+				float distance2 = dx * dx + dy * dy;
+				if (distance2 > reduced2) continue; // 格子在范围内但物体在圆外
+				obj->lodTier = distance2 <= full2 ? UpdateTier::FULL : UpdateTier::REDUCED;
+				obj->lodSeenFrame = lodFrame;
+				lodNextAwake.push_back(obj);
+			}
+		}
+	}
+	
+	// 2. 上一帧醒着、这一帧不在范围内的入睡
+	for (GameObject* obj : lodAwakeList) {
+		if (obj->lodSeenFrame != lodFrame) {
+			obj->lodAwake = false;
+			obj->lodTier = UpdateTier::DORMANT;
+			obj->lodSleepClock = lodClock - deltaTime; // 本帧的时间还没给它，醒来时一并补上
+		}
+	}
+	lodAwakeList.swap(lodNextAwake);
+	
+	// 3. 更新醒着的物体；刚醒来的补上睡眠期间的时间
+	for (size_t i = 0; i < lodAwakeList.size(); ++i) {
+		GameObject* obj = lodAwakeList[i];
+		if (!obj->lodAwake) {
+			obj->lodAwake = true;
+			float slept = (float)(lodClock - deltaTime - obj->lodSleepClock);
+			obj->lodPendingDelta += std::min(std::max(slept, 0.0f), lodMaxCatchUp);
+		}
+		if (!obj->IsVisible()) {
+			obj->lodPendingDelta = 0.0f;
+			continue;
+		}
+		obj->lodPendingDelta += deltaTime;
+		if (obj->lodTier == UpdateTier::FULL || (lodFrame + obj->lodPhase) % lodReducedInterval == 0) {
+			float elapsed = obj->lodPendingDelta;
+			obj->lodPendingDelta = 0.0f;
+			obj->Update(elapsed);
+			LodReindex(obj);
+		}
+	}
+}
+
+void GameObjectSystem::EnsureStaticSolids() const {
+	if (!staticDirty) return;
+	staticDirty = false;
+	staticSolids.clear();
+	for (const auto& [id, obj] : objects) {
+		if (!dynamic_cast<const ImageObject*>(obj.get())) continue;
+		const std::vector<Rectangle>& rects = obj->GetWorldCollisionRects();
+		const std::vector<CollisionComponent>& components = obj->GetCollisionComponents();
+		for (size_t i = 0; i < rects.size(); ++i) {
+			if (components[i].isSolid) staticSolids.push_back({obj.get(), rects[i]});
+		}
+	}
+	BuildBroadphaseGrid(staticSolids.size(), [this](size_t i, Rectangle& rect) {
+		rect = staticSolids[i].rect;
+		return true;
+	}, 128.0f, staticGrid);
+}
+
+// ==================== ImageObject 实现 ====================
+
+void ImageObject::SetTexture(Texture2D newTexture) {
+	texture = AdoptTexture(newTexture);
+	UpdateCollisionComponents();
+}
+
+void ImageObject::SetScale(float newScale) {
+	scale = newScale;
+	UpdateCollisionComponents();
+}
+
+void ImageObject::SetOrigin(const Vector2& newOrigin) {
+	origin = newOrigin;
+	UpdateCollisionComponents();
+}
+
+void ImageObject::UpdateCollisionComponents() {
+	if (!texture.IsReady() || textureBoundsIndex < 0) return;
+	
+	// 纹理可能在加入系统之后才就绪（流式加载），旧的零尺寸范围和新范围都要让寻路网格知道
+	RecordGeometryChange();
+	// 更新基于纹理的碰撞箱，与 GetBounds 一致
+	Texture2D tex = texture.Get();
+	Rectangle& rect = collisionComponents[textureBoundsIndex].rect;
+	rect.x = -origin.x * scale;
+	rect.y = -origin.y * scale;
+	rect.width = tex.width * scale;
+	rect.height = tex.height * scale;
+	MarkBoundsDirty();
+	RecordGeometryChange();
+}
+
+// ==================== Character 实现 ====================
+
+Character::Character(const std::string& objId)
+: GameObject(objId), speed(200.0f), currentDirection(Direction::DOWN),
+currentState(AnimationState::IDLE), feetIndex(-1) {
+	oldPosition = {0, 0};
+	animator = CreateAnimator();
+}
+
+Character::~Character() {
+	UnloadResources();
+	DestroyAnimator(animator);
+}
+
+bool Character::LoadCharacterSheet(const std::string& texturePath) {
+	// 精灵表在后台解码，就绪后片段建好帧表，再按精灵尺寸设置碰撞箱
+	sheetPath = texturePath;
+	ResolveClip();
+	characterSheet = RequestTexture(texturePath, RED);
+	characterSheet.OnReady([this]() { ApplySheetLayout(); });
+	// 解码在后台进行，这里只能判断来源是否存在：资源包条目或磁盘文件
+	return assetPack.Contains(texturePath) || FileExists(texturePath.c_str());
+}
+
+void Character::ResolveClip() {
+	if (sheetPath.empty()) return;
+	clip = LoadAnimationClip(sheetPath, sheetLayout);
+	SetAnimatorClip(animator, *clip);
+}
+
+void Character::ApplySheetLayout() {
+	if (characterSheet.IsFailed()) return;
+	
+	// 不依赖片段的回调顺序，直接按布局从贴图尺寸算精灵大小
+	Texture2D sheet = characterSheet.Get();
+	float spriteWidth = (float)(sheet.width / sheetLayout.columns);
+	float spriteHeight = (float)(sheet.height / sheetLayout.rows);
+	
+	// 设置角色碰撞箱（位于脚部）
+	float collisionWidth = spriteWidth * 0.5f;
+	float collisionHeight = spriteHeight * 0.25f;
+	
+	Rectangle feet = {-collisionWidth / 2.0f, spriteHeight / 2.0f - collisionHeight, collisionWidth, collisionHeight};
+	
+	// 重新加载精灵表或换布局时原地更新已有的脚部碰撞箱，不再追加
+	if (feetIndex >= 0) {
+		collisionComponents[feetIndex].rect = feet;
+		MarkBoundsDirty();
+		return;
+	}
+	feetIndex = (int)collisionComponents.size();
+	AddCollisionComponent(feet, RED, true, "character_feet");
+}
+
+void Character::SaveState(SnapshotWriter& out) const {
+	GameObject::SaveState(out);
+	out.Write((int32_t)currentDirection);
+	out.Write((int32_t)currentState);
+	out.Write((int32_t)GetAnimatorFrame(animator));
+	out.Write(GetAnimatorTimer(animator));
+}
+
+bool Character::LoadState(SnapshotReader& in) {
+	int32_t direction = 0;
+	int32_t state = 0;
+	int32_t frame = 0;
+	float timer = 0.0f;
+	if (!GameObject::LoadState(in) || !in.Read(direction) || !in.Read(state) ||
+		!in.Read(frame) || !in.Read(timer)) {
+		return false;
+	}
+	currentDirection = (Direction)direction;
+	currentState = (AnimationState)state;
+	SetAnimatorState(animator, frame, timer);
+	oldPosition = position;
+	return true;
+}
+
+void Character::UnloadResources() {
+	characterSheet.Reset();
+	clip.reset();
+}
+
+void Character::HandleInput() {
+	oldPosition = position; // 保存旧位置用于碰撞解决
+	
+	Vector2 movement = {0, 0};
+	bool isMoving = false;
+	
+	if (InputDown(KEY_RIGHT) || InputDown(KEY_D)) {
+		movement.x += 1;
+		currentDirection = Direction::RIGHT;
+		isMoving = true;
+	}
+	if (InputDown(KEY_LEFT) || InputDown(KEY_A)) {
+		movement.x -= 1;
+		currentDirection = Direction::LEFT;
+		isMoving = true;
+	}
+	if (InputDown(KEY_UP) || InputDown(KEY_W)) {
+		movement.y -= 1;
+		currentDirection = Direction::UP;
+		isMoving = true;
+	}
+	if (InputDown(KEY_DOWN) || InputDown(KEY_S)) {
+		movement.y += 1;
+		currentDirection = Direction::DOWN;
+		isMoving = true;
+	}
+	
+	currentState = isMoving ? AnimationState::WALKING : AnimationState::IDLE;
+	
+	if (isMoving) {
+		if (movement.x != 0 && movement.y != 0) {
+			movement.x *= 0.7071f;
+			movement.y *= 0.7071f;
+		}
+		position.x += movement.x * speed * GetInputDeltaTime();
+		position.y += movement.y * speed * GetInputDeltaTime();
+		MarkBoundsDirty();
+	}
+}
+
+void Character::Update(float deltaTime) {
+	// 只登记，帧在 UpdateAnimations 里与其他角色一起推进
+	TickAnimator(animator, currentState == AnimationState::WALKING, deltaTime);
+}
+
+void Character::ResolveCollision() {
+	position = oldPosition; // 回到碰撞前的位置
+	MarkBoundsDirty();
+}
+
+void Character::ResolveCollision(const Vector2& oldPosition) {
+	position = oldPosition; // 碰撞箱跟随位置，无需单独恢复
+	MarkBoundsDirty();
+}
+
+Rectangle Character::GetCollisionBox() const {
+	if (feetIndex < 0) return {position.x, position.y, 0, 0};
+	return GetWorldCollisionRects()[feetIndex];
+}
+
+void Character::ClearCollisionComponents() {
+	GameObject::ClearCollisionComponents();
+	feetIndex = -1;
+}
+
+void Character::Draw() const {
+	if (!clip || !clip->IsReady() || !visible) return;
+	
+	// 源矩形直接查片段的帧表
+	const Rectangle& sourceRect = clip->GetFrame((int)currentDirection, GetAnimatorFrame(animator));
+	float spriteWidth = (float)clip->GetFrameWidth();
+	float spriteHeight = (float)clip->GetFrameHeight();
+	DrawTexturePro(
+				   clip->GetSheet().Get(),
+				   sourceRect,
+				   { position.x, position.y, spriteWidth, spriteHeight },
+				   { spriteWidth / 2.0f, spriteHeight / 2.0f },
+				   0.0f,
+				   WHITE
+				   );
+}
+
+void Character::DrawDebug() const {
+	if (!visible) return;
+	
+	// 绘制碰撞箱
+	const std::vector<Rectangle>& rects = GetWorldCollisionRects();
+	for (size_t i = 0; i < collisionComponents.size(); ++i) {
+		const CollisionComponent& collision = collisionComponents[i];
+		if (collision.visible) {
+			const Rectangle& worldRect = rects[i];
+			
+			if (collision.isSolid) {
+				DrawRectangleRec(worldRect, Fade(collision.debugColor, 0.5f));
+				DrawRectangleLinesEx(worldRect, 2.0f, collision.debugColor);
+			} else {
+				DrawRectangleRec(worldRect, Fade(collision.debugColor, 0.3f));
+				DrawRectangleLinesEx(worldRect, 1.0f, collision.debugColor);
+			}
+			
+			// 绘制碰撞箱名称
+			if (!collision.name.empty()) {
+				DrawTextUTF(collision.name, Vector2{worldRect.x + 5, worldRect.y + 5}, 10, 1, BLACK);
+			}
+		}
+	}
+}
+
+void Character::CheckWorldBounds(const Vector2& worldSize) {
+	Rectangle bounds = GetBounds();
+	if (position.x < bounds.width / 2.0f) {
+		position.x = bounds.width / 2.0f;
+	}
+	if (position.y < bounds.height / 2.0f) {
+		position.y = bounds.height / 2.0f;
+	}
+	if (position.x > worldSize.x - bounds.width / 2.0f) {
+		position.x = worldSize.x - bounds.width / 2.0f;
+	}
+	if (position.y > worldSize.y - bounds.height / 2.0f) {
+		position.y = worldSize.y - bounds.height / 2.0f;
+	}
+	MarkBoundsDirty();
+}
+
+void Character::SetAnimationSpeed(float newSpeed) {
+	sheetLayout.frameTime = newSpeed;
+	ResolveClip();
+}
+
+void Character::SetSpriteLayout(int down, int left, int right, int up) {
+	sheetLayout.directionRows[(int)Direction::DOWN] = down;
+	sheetLayout.directionRows[(int)Direction::LEFT] = left;
+	sheetLayout.directionRows[(int)Direction::RIGHT] = right;
+	sheetLayout.directionRows[(int)Direction::UP] = up;
+	ResolveClip();
+}
+
+Rectangle Character::GetBounds() const {
+	float spriteWidth = clip && clip->IsReady() ? (float)clip->GetFrameWidth() : 0.0f;
+	float spriteHeight = clip && clip->IsReady() ? (float)clip->GetFrameHeight() : 0.0f;
+	return {
+	position.x - spriteWidth / 2.0f,
+	position.y - spriteHeight / 2.0f,
+	spriteWidth,
+	spriteHeight
+};
+}
+
+void Character::UpdateCollisionComponents() {
+	// 如果需要更新碰撞箱，可以在这里实现
+}
+
+// ==================== CollisionSystem 实现 ====================
+
+void CollisionSystem::AddCollisionBox(const Rectangle& rect, const Color& color, bool isSolid, const std::string& name, int owner) {
+	collisionBoxes.push_back({rect, color, isSolid, name, owner});
+	if (isSolid) {
+		changes.Add(rect);
+		gridDirty = true;
+	}
+}
+
+void CollisionSystem::RemoveOwner(int owner) {
+	collisionBoxes.erase(std::remove_if(collisionBoxes.begin(), collisionBoxes.end(),
+	[this, owner](const CollisionBox& box) {
+		if (box.owner != owner) return false;
+		if (box.isSolid) changes.Add(box.rect);
+		return true;
+	}), collisionBoxes.end());
+	gridDirty = true; // 下标变了
+}
+
+bool CollisionSystem::EnsureBroadphase() const {
+	if (gridDirty) {
+		gridDirty = false;
+		if (collisionBoxes.size() < 16) {
+			grid.cols = grid.rows = 0;
+		} else {
+			BuildBroadphaseGrid(collisionBoxes.size(), [this](size_t i, Rectangle& rect) {
+				rect = collisionBoxes[i].rect;
+				return collisionBoxes[i].isSolid;
+			}, gridCellSize, grid);
+		}
+	}
+	return grid.cols > 0;
+}
+
+bool CollisionSystem::CheckCollision(const Rectangle& rect) const {
+	if (EnsureBroadphase()) {
+		// 只检查 rect 覆盖到的格子；一个碰撞箱可能被检查多次，但结果只是有或没有
+		const Rectangle& bounds = grid.bounds;
+		if (rect.x > bounds.x + bounds.width || rect.y > bounds.y + bounds.height ||
+			rect.x + rect.width < bounds.x || rect.y + rect.height < bounds.y) {
+			return false;
+		}
+		int x0 = std::max(0, (int)((rect.x - bounds.x) / grid.cellSize));
+		int y0 = std::max(0, (int)((rect.y - bounds.y) / grid.cellSize));
+		int x1 = std::min(grid.cols - 1, (int)((rect.x + rect.width - bounds.x) / grid.cellSize));
+		int y1 = std::min(grid.rows - 1, (int)((rect.y + rect.height - bounds.y) / grid.cellSize));
+		for (int y = y0; y <= y1; ++y) {
+			for (int x = x0; x <= x1; ++x) {
+				int cell = y * grid.cols + x;
+				for (uint32_t k = grid.cellStart[cell]; k < grid.cellStart[cell + 1]; ++k) {
+					if (CheckCollisionRecs(rect, collisionBoxes[grid.items[k]].rect)) return true;
+				}
+			}
+		}
+		return false;
+	}
+	for (const auto& box : collisionBoxes) {
+		if (box.isSolid && CheckCollisionRecs(rect, box.rect)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void CollisionSystem::Draw() const {
+	for (const auto& box : collisionBoxes) {
+		if (box.isSolid) {
+			DrawRectangleRec(box.rect, Fade(box.color, 0.7f));
+			DrawRectangleLinesEx(box.rect, 2.0f, Fade(BLACK, 0.5f));
+		} else {
+			DrawRectangleRec(box.rect, Fade(box.color, 0.3f));
+			DrawRectangleLinesEx(box.rect, 1.0f, Fade(BLACK, 0.3f));
+		}
+		
+		// 绘制碰撞箱名称
+		if (!box.name.empty()) {
+			DrawTextUTF(box.name, Vector2{box.rect.x + 5, box.rect.y + 5}, 10, 1, BLACK);
+		}
+	}
+}
+
+void CollisionSystem::Clear() {
+	collisionBoxes.clear();
+	changes.Reset();
+	gridDirty = true;
+}
+
+// ==================== CameraSystem 实现 ====================
+
+CameraSystem::CameraSystem() {
+	camera = {0};
+	camera.offset = (Vector2){GetScreenWidth() / 2.0f, GetScreenHeight() / 2.0f};
+	camera.rotation = 0.0f;
+	camera.zoom = 1.0f;
+	targetOffset = {0, 0};
+}
+
+void CameraSystem::Update(const Vector2& targetPosition) {
+	camera.target = targetPosition;
+	// 窗口大小可能变化，每帧按当前窗口居中
+	camera.offset = {GetScreenWidth() / 2.0f, GetScreenHeight() / 2.0f};
+}
+
+Rectangle CameraSystem::GetViewRect() const {
+	float zoom = camera.zoom > 0 ? camera.zoom : 1.0f;
+	return {
+		camera.target.x - camera.offset.x / zoom,
+		camera.target.y - camera.offset.y / zoom,
+		GetScreenWidth() / zoom,
+		GetScreenHeight() / zoom
+	};
+}
+
+void CameraSystem::BeginMode() const {
+	// 画到内部渲染目标时按渲染比例换算
+	BeginMode2D(GetRenderCamera(camera));
+}
+
+void CameraSystem::EndMode() const {
+	EndMode2D();
+}
+
+// ==================== 工具函数实现 ====================
+
+const char* CharacterUtils::DirectionToString(Direction dir) {
+	switch (dir) {
+		case Direction::DOWN: return "向下";
+		case Direction::LEFT: return "向左";
+		case Direction::RIGHT: return "向右";
+		case Direction::UP: return "向上";
+		default: return "未知";
+	}
+}
+
+const char* CharacterUtils::StateToString(AnimationState state) {
+	switch (state) {
+		case AnimationState::IDLE: return "站立";
+		case AnimationState::WALKING: return "行走";
+		default: return "未知";
+	}
+}
+
+Vector2 CharacterUtils::GetMovementVector(Direction dir) {
+	switch (dir) {
+		case Direction::DOWN: return {0, 1};
+		case Direction::LEFT: return {-1, 0};
+		case Direction::RIGHT: return {1, 0};
+		case Direction::UP: return {0, -1};
+		default: return {0, 0};
+	}
+}
+
+#endif // CHARACTER_H
@@ -0,0 +1,492 @@
+#include "raylib.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include "nbsfont.h"
+#include "asset.h"
+#include "dialogscript.h"
+#include "snapshot.h"
+#include "tween.h"
+#include "uilayer.h"
+#include <algorithm>
+
+enum class DialogState { HIDDEN, TYPING, COMPLETE, CHOICE };
+
+struct DialogOption {
+	std::string text;
+	int nextDialogId;
+};
+
+struct Dialog {
+	int id;
+	std::string characterName;
+	std::string text;
+	std::string portraitPath;
+	TextureHandle portrait; // 首次进入或被预取时才请求
+	std::vector<DialogOption> options;
+	int nextDialogId;
+};
+
+class DialogSystem {
+private:
+	std::unordered_map<int, Dialog> dialogs; // 按 id 索引，节点地址在插入后保持不变
+	DialogScript script;                     // 脚本节点在首次到达时才解码进 dialogs
+	DialogState currentState;
+	int currentDialogId;
+	Dialog* currentDialog; // 缓存当前节点，避免每帧查找
+	int prefetchDepth;     // 立绘预取的步数
+	int currentCharIndex;
+	float typeProgress; // 打字进度（字节，由补间推进）
+	float typeSpeed;    // 每显示 3 字节（一个汉字）所需秒数
+	TweenId typeTween;
+	int selectedOption;
+
+	Rectangle dialogBox;
+	Rectangle portraitBox;
+	Rectangle textBox;
+	Rectangle optionBox;
+
+	Color boxColor;
+	Color textColor;
+	Color highlightColor;
+
+	Font font;
+	int boxPanel; // 对话框（底框、名字、正文、提示）缓存在 UI 面板里，内容变化时才重画
+
+	Dialog* GetCurrentDialog();
+	Dialog* FindDialog(int id);
+	void RequestPortrait(Dialog& dialog);
+	void PrefetchPortraits(int startId);
+	void StartTyping(float fromProgress);
+	void ConfirmOption();
+
+public:
+	DialogSystem();
+	~DialogSystem();
+
+	void AddDialog(int id, const std::string& name, const std::string& text,
+	               const std::string& portraitPath, int nextId);
+	void AddOption(int id, const std::string& text, int nextId);
+	bool LoadScript(const std::string& path);
+	bool LoadScriptSource(const std::string& path);
+	void SetPrefetchDepth(int depth) { prefetchDepth = depth < 0 ? 0 : depth; }
+	void StartDialog(int startId);
+	void Update();
+	void Draw();
+	int HandleInput();
+	bool IsActive() const;
+
+	// 存档：保存对话进度（当前节点和打字进度）
+	void SaveState(SnapshotWriter& out) const;
+	bool LoadState(SnapshotReader& in);
+};
+
+DialogSystem::DialogSystem() {
+	currentState = DialogState::HIDDEN;
+	currentDialogId = -1;
+	currentDialog = nullptr;
+	prefetchDepth = 2;
+	currentCharIndex = 0;
+	typeProgress = 0.0f;
+	typeSpeed = 0.05f; // 加快文字显示速度：从0.05f改为0.02f
+	typeTween = 0;
+	selectedOption = 0;
+
+	// 初始化时先设置默认值，Draw()中会动态计算
+	dialogBox = { 50, 300, 500, 150 };
+	portraitBox = { 0, 0, 0, 0 };
+	textBox = { 70, 320, 460, 110 };
+	optionBox = { 400, 380, 300, 80 };
+
+	boxColor = { 30, 30, 40, 240 };
+	textColor = WHITE;
+	highlightColor = { 255, 203, 0, 255 };
+
+	font = GetFontDefault();
+	boxPanel = CreateUiPanel();
+}
+
+DialogSystem::~DialogSystem() {
+	// 立绘纹理由资源加载器统一管理
+	KillTweensOf(this);
+	ReleaseUiPanel(boxPanel);
+}
+
+void DialogSystem::AddDialog(int id, const std::string& name, const std::string& text,
+                             const std::string& portraitPath, int nextId) {
+	auto it = dialogs.find(id);
+	if (it == dialogs.end()) {
+		Dialog dialog;
+		dialog.id = id;
+		dialog.characterName = name;
+		dialog.text = text;
+		dialog.nextDialogId = nextId;
+		dialog.portraitPath = portraitPath;
+		dialogs.emplace(id, std::move(dialog));
+		return;
+	}
+
+	// 正在显示的节点不能在对话中途改掉（打字进度和已显示的文字会对不上）
+	if (currentState != DialogState::HIDDEN && currentDialogId == id) {
+		TraceLog(LOG_WARNING, "DIALOG: 节点 %d 正在显示，忽略替换", id);
+		return;
+	}
+
+	// 已有节点只合并说话人和文字，保留选项和已请求的立绘
+	Dialog& dialog = it->second;
+	dialog.characterName = name;
+	dialog.text = text;
+	dialog.nextDialogId = nextId;
+	if (dialog.portraitPath != portraitPath) {
+		dialog.portraitPath = portraitPath;
+		dialog.portrait.Reset();
+	}
+}
+
+/// 加载编译好的对话脚本（替换现有全部对话）
+bool DialogSystem::LoadScript(const std::string& path) {
+	dialogs.clear();
+	currentDialog = nullptr;
+	currentDialogId = -1;
+	currentState = DialogState::HIDDEN;
+	return script.Open(path);
+}
+
+/// 加载文本对话脚本并在内存中编译（没有离线编译结果时使用）
+bool DialogSystem::LoadScriptSource(const std::string& path) {
+	dialogs.clear();
+	currentDialog = nullptr;
+	currentDialogId = -1;
+	currentState = DialogState::HIDDEN;
+	return script.OpenSource(path);
+}
+
+void DialogSystem::AddOption(int id, const std::string& text, int nextId) {
+	Dialog* dialog = FindDialog(id);
+	if (dialog) {
+		dialog->options.push_back({text, nextId});
+	}
+}
+
+void DialogSystem::RequestPortrait(Dialog& dialog) {
+	// 同一路径的立绘由资源加载器共享，只解码一次
+	if (!dialog.portrait.IsValid()) {
+		dialog.portrait = RequestTexture(dialog.portraitPath, dialog.portraitPath.empty() ? GRAY : BLUE, 128);
+	}
+}
+
+void DialogSystem::PrefetchPortraits(int startId) {
+	// 沿 nextDialogId 和选项广度优先向后走 prefetchDepth 步
+	std::vector<int> frontier = {startId};
+	std::vector<int> next;
+	std::unordered_set<int> visited = {startId};
+	for (int depth = 0; depth <= prefetchDepth && !frontier.empty(); ++depth) {
+		next.clear();
+		for (int id : frontier) {
+			Dialog* dialog = FindDialog(id);
+			if (!dialog) continue;
+			RequestPortrait(*dialog);
+
+			if (dialog->nextDialogId != -1 && visited.insert(dialog->nextDialogId).second) {
+				next.push_back(dialog->nextDialogId);
+			}
+			for (const auto& option : dialog->options) {
+				if (option.nextDialogId != -1 && visited.insert(option.nextDialogId).second) {
+					next.push_back(option.nextDialogId);
+				}
+			}
+		}
+		frontier.swap(next);
+	}
+}
+
+void DialogSystem::StartDialog(int startId) {
+	AllowFrameAllocations(); // 首次到达的节点需要解码
+	currentDialogId = startId;
+	currentDialog = FindDialog(startId);
+	PrefetchPortraits(startId);
+	currentState = DialogState::TYPING;
+	selectedOption = 0;
+	StartTyping(0.0f);
+}
+
+/// 按秒推进打字效果，与帧率无关；只停在完整的 UTF-8 字符边界上
+void DialogSystem::StartTyping(float fromProgress) {
+	KillTween(typeTween);
+	typeTween = 0;
+	typeProgress = fromProgress;
+	currentCharIndex = (int)fromProgress;
+	if (!currentDialog) return;
+
+	float length = (float)currentDialog->text.length();
+	float bytesPerSecond = 3.0f / (typeSpeed > 0 ? typeSpeed : 0.05f);
+	if (fromProgress >= length) return;
+
+	typeTween = StartTween(fromProgress, length, (length - fromProgress) / bytesPerSecond,
+	[this](float progress) {
+		if (!currentDialog) return;
+		const std::string& text = currentDialog->text;
+		int index = (int)progress;
+		while (index < (int)text.length() && ((unsigned char)text[index] & 0xC0) == 0x80) ++index;
+		typeProgress = progress;
+		currentCharIndex = index;
+	}, EaseLinear, 0.0f, this);
+}
+
+void DialogSystem::SaveState(SnapshotWriter& out) const {
+	out.Write((int32_t)currentState);
+	out.Write((int32_t)currentDialogId);
+	out.Write((int32_t)currentCharIndex);
+	out.Write(typeProgress);
+	out.Write((int32_t)selectedOption);
+}
+
+bool DialogSystem::LoadState(SnapshotReader& in) {
+	int32_t state = 0;
+	int32_t dialogId = -1;
+	int32_t charIndex = 0;
+	float progress = 0.0f;
+	int32_t option = 0;
+	if (!in.Read(state) || !in.Read(dialogId) || !in.Read(charIndex) ||
+	    !in.Read(progress) || !in.Read(option)) {
+		return false;
+	}
+
+	// 损坏或过期的存档：状态越界或节点已不在脚本中时回到空闲（HIDDEN）
+	bool validState = state >= (int32_t)DialogState::HIDDEN && state <= (int32_t)DialogState::CHOICE;
+	Dialog* dialog = validState && state != (int32_t)DialogState::HIDDEN ? FindDialog(dialogId) : nullptr;
+	if (!dialog) {
+		KillTween(typeTween);
+		typeTween = 0;
+		currentState = DialogState::HIDDEN;
+		currentDialogId = -1;
+		currentDialog = nullptr;
+		currentCharIndex = 0;
+		typeProgress = 0.0f;
+		selectedOption = 0;
+		return true;
+	}
+
+	currentState = (DialogState)state;
+	currentDialogId = dialogId;
+	currentDialog = dialog;
+	if (currentState == DialogState::CHOICE && dialog->options.empty()) {
+		currentState = DialogState::COMPLETE;
+	}
+	int textLength = (int)dialog->text.length();
+	if (charIndex < 0) charIndex = 0;
+	if (charIndex > textLength) charIndex = textLength;
+	if (!(progress >= 0.0f)) progress = 0.0f; // 也挡住 NaN
+	if (progress > (float)textLength) progress = (float)textLength;
+	selectedOption = option >= 0 && option < (int32_t)dialog->options.size() ? option : 0;
+	if (currentState == DialogState::TYPING) {
+		StartTyping(progress);
+	} else {
+		KillTween(typeTween);
+		typeTween = 0;
+		typeProgress = progress;
+	}
+	currentCharIndex = charIndex;
+	if (currentState != DialogState::HIDDEN) {
+		PrefetchPortraits(dialogId);
+	}
+	return true;
+}
+
+void DialogSystem::Update() {
+	PROFILE_SCOPE("dialog update");
+	// 打字进度由补间推进（UpdateTweens），这里只检查是否打完
+	if (currentState == DialogState::TYPING) {
+		Dialog* currentDialog = GetCurrentDialog();
+		if (currentDialog && currentCharIndex >= (int)currentDialog->text.length()) {
+			currentState = currentDialog->options.empty() ? DialogState::COMPLETE : DialogState::CHOICE;
+		}
+	}
+}
+
+void DialogSystem::Draw() {
+	PROFILE_SCOPE("dialog draw");
+	if (currentState == DialogState::HIDDEN) return;
+
+	Dialog* currentDialog = GetCurrentDialog();
+	if (!currentDialog) return;
+	RequestPortrait(*currentDialog);
+
+	// 获取窗口尺寸
+	int screenWidth = GetScreenWidth();
+	int screenHeight = GetScreenHeight();
+
+	// 计算立绘大小和位置（高度为宽度的一倍，即2:1比例，靠窗口底部）
+	int portraitWidth = screenHeight / 3;  // 宽度为屏幕高度的1/3
+	int portraitHeight = portraitWidth * 2; // 高度为宽度的2倍（2:1比例）
+	int portraitX = screenWidth - portraitWidth - 20; // 右侧留20像素边距
+	int portraitY = screenHeight - portraitHeight; // 底部对齐
+
+	// 更新立绘矩形 - 移除了黑色背景和边框
+	portraitBox = { (float)portraitX, (float)portraitY, (float)portraitWidth, (float)portraitHeight };
+
+	// 调整对话框宽度，为立绘留出空间
+	dialogBox = { 50, (float)(screenHeight - 180), (float)(screenWidth - portraitWidth - 80), 150 };
+	textBox = { 70, (float)(screenHeight - 160), dialogBox.width - 40, 110 };
+
+	// 计算立绘缩放和位置
+	// 保持原始纹理的纵横比，避免拉伸变形
+	Texture2D portrait = currentDialog->portrait.Get();
+	float scaleX = portraitBox.width / (float)portrait.width;
+	float scaleY = portraitBox.height / (float)portrait.height;
+	float scale = std::min(scaleX, scaleY);
+
+	float scaledWidth = portrait.width * scale;
+	float scaledHeight = portrait.height * scale;
+
+	// 居中显示在立绘区域内
+	Rectangle dest = {
+		portraitBox.x + (portraitBox.width - scaledWidth) / 2,
+		portraitBox.y + (portraitBox.height - scaledHeight) / 2,
+		scaledWidth,
+		scaledHeight
+	};
+
+	// 绘制立绘 - 直接绘制到目标矩形，不添加背景或边框（本身就是一个四边形，不进面板）
+	DrawTexturePro(portrait,
+	{0, 0, (float)portrait.width, (float)portrait.height},
+	dest, {0, 0}, 0.0f, WHITE);
+
+	// 只画已打出的前缀，不复制字符串
+	size_t displayLength = std::min((size_t)std::max(currentCharIndex, 0), currentDialog->text.size());
+	bool complete = currentState == DialogState::COMPLETE;
+
+	// 对话框面板：名字、已打出的文字、是否显示提示或尺寸变了才重画
+	const float margin = 2.0f; // 给圆角边线留的余量
+	uint64_t key = MixUiKey(UI_KEY_SEED, currentDialog->characterName);
+	key = MixUiKey(key, currentDialog->text.c_str(), displayLength);
+	key = MixUiKey(key, (int64_t)complete);
+	bool choosing = currentState == DialogState::CHOICE;
+	key = MixUiKey(key, choosing ? (int64_t)selectedOption : (int64_t)-1);
+	if (BeginUiPanel(boxPanel, (int)(dialogBox.width + margin * 2), (int)(dialogBox.height + margin * 2), key)) {
+		Rectangle box = {margin, margin, dialogBox.width, dialogBox.height};
+		float textX = textBox.x - dialogBox.x + margin;
+		float textY = textBox.y - dialogBox.y + margin;
+
+		// 绘制对话框
+		DrawRectangleRounded(box, 0.1f, 8, boxColor);
+		DrawRectangleRoundedLines(box, 0.1f, 8, WHITE);
+
+		// 绘制角色名称
+		DrawTextUTF(currentDialog->characterName, Vector2{textX, textY - 10}, 18, 1, YELLOW);
+
+		// 使用自定义文本绘制函数，支持换行
+		DrawTextUTF(currentDialog->text.c_str(), displayLength, Vector2{textX, textY + 20}, 20, 1, textColor);
+
+		if (complete) {
+			DrawTextUTF("按空格继续", Vector2{box.x + box.width - 120, box.y + box.height - 25}, 16, 1, LIGHTGRAY);
+		}
+
+		// 选项列在正文下方，选中的一项高亮
+		if (choosing) {
+			for (size_t i = 0; i < currentDialog->options.size(); ++i) {
+				bool selected = (int)i == selectedOption;
+				DrawTextUTF(selected ? "> " : "  ", Vector2{textX, textY + 50 + i * 22.0f}, 18, 1,
+				            selected ? highlightColor : LIGHTGRAY);
+				DrawTextUTF(currentDialog->options[i].text, Vector2{textX + 20, textY + 50 + i * 22.0f}, 18, 1,
+				            selected ? highlightColor : LIGHTGRAY);
+			}
+		}
+		EndUiPanel();
+	}
+	DrawUiPanel(boxPanel, {dialogBox.x - margin, dialogBox.y - margin});
+}
+
+/// 确认当前选中的选项：跳到它的目标节点，目标为 -1 时结束对话
+void DialogSystem::ConfirmOption() {
+	Dialog* currentDialog = GetCurrentDialog();
+	if (!currentDialog || currentDialog->options.empty()) {
+		currentState = DialogState::HIDDEN;
+		return;
+	}
+	int count = (int)currentDialog->options.size();
+	if (selectedOption < 0 || selectedOption >= count) selectedOption = 0;
+	int nextId = currentDialog->options[selectedOption].nextDialogId;
+	if (nextId != -1 && FindDialog(nextId)) {
+		StartDialog(nextId);
+	} else {
+		currentState = DialogState::HIDDEN;
+	}
+}
+
+int DialogSystem::HandleInput() {
+	if (InputPressed(KEY_SPACE)) {
+		if (currentState == DialogState::TYPING) {
+			Dialog* currentDialog = GetCurrentDialog();
+			if (currentDialog) {
+				KillTween(typeTween);
+				typeTween = 0;
+				currentCharIndex = (int)currentDialog->text.length();
+				typeProgress = (float)currentCharIndex;
+				currentState = currentDialog->options.empty() ? DialogState::COMPLETE : DialogState::CHOICE;
+			}
+		} else if (currentState == DialogState::COMPLETE) {
+			Dialog* currentDialog = GetCurrentDialog();
+			if (currentDialog && currentDialog->nextDialogId != -1) {
+				StartDialog(currentDialog->nextDialogId);
+			} else {
+				currentState = DialogState::HIDDEN;
+			}
+		} else if (currentState == DialogState::CHOICE) {
+			ConfirmOption();
+		}
+		return 1;
+	}
+	// 选项：上下（W/S）切换，空格或回车确认
+	if (currentState == DialogState::CHOICE) {
+		Dialog* currentDialog = GetCurrentDialog();
+		int count = currentDialog ? (int)currentDialog->options.size() : 0;
+		if (count == 0) {
+			currentState = DialogState::COMPLETE;
+			return 0;
+		}
+		// W/S 也是移动键，切换选项时返回 0，角色不会跟着走
+		if (InputPressed(KEY_UP) || InputPressed(KEY_W)) {
+			selectedOption = (selectedOption + count - 1) % count;
+			return 0;
+		}
+		if (InputPressed(KEY_DOWN) || InputPressed(KEY_S)) {
+			selectedOption = (selectedOption + 1) % count;
+			return 0;
+		}
+		if (InputPressed(KEY_ENTER)) {
+			ConfirmOption();
+			return 1;
+		}
+	}
+	return 0;
+}
+
+bool DialogSystem::IsActive() const {
+	return currentState != DialogState::HIDDEN;
+}
+
+Dialog* DialogSystem::GetCurrentDialog() {
+	return currentDialog;
+}
+
+Dialog* DialogSystem::FindDialog(int id) {
+	auto it = dialogs.find(id);
+	if (it != dialogs.end()) return &it->second;
+
+	// 首次到达的脚本节点：从脚本数据解码并缓存
+	DialogNodeView view;
+	if (!script.Decode(id, view)) return nullptr;
+
+	Dialog& dialog = dialogs[id];
+	dialog.id = view.id;
+	dialog.characterName.assign(view.name);
+	dialog.text.assign(view.text);
+	dialog.portraitPath.assign(view.portrait);
+	dialog.nextDialogId = view.nextId;
+	for (int i = 0; i < view.optionCount; ++i) {
+		dialog.options.push_back({std::string(script.GetString(view.options[i].text)), view.options[i].nextId});
+	}
+	return &dialog;
+}
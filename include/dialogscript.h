@@ -0,0 +1,390 @@
+#ifndef DIALOGSCRIPT_H
+#define DIALOGSCRIPT_H
+
+#include "raylib.h"
+#include "assetpack.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <climits>
+#include <cstdint>
+
+// ==================== 对话脚本文本格式 ====================
+//
+// # 注释
+// [1] ZFX学姐 @resource/zfx.png     节点 id、角色名、立绘路径（可省略）
+// 同城月跑，有钱月吗                 正文，可以有多行
+// * 好啊 -> 5                        选项：文本 -> 目标节点
+// -> 2                               下一个节点（省略则对话结束）
+//
+// ==================== 对话脚本二进制格式 ====================
+//
+// [DialogScriptHeader]
+// [DialogIndexEntry * nodeCount]     按 id 升序，二分查找
+// [DialogStringEntry * stringCount]  字符串表（相同字符串只存一份）
+// [字符串数据]
+// [节点记录]                         DialogNodeRecord + DialogOptionRecord * optionCount
+//
+// 所有整数均为小端序，所有记录按 4 字节对齐。
+
+static const char DIALOG_SCRIPT_MAGIC[4] = {'N', 'B', 'D', 'G'};
+static const uint32_t DIALOG_SCRIPT_VERSION = 1;
+static const uint32_t DIALOG_NO_STRING = 0xFFFFFFFFu;
+
+struct DialogScriptHeader {
+	char magic[4];
+	uint32_t version;
+	uint32_t nodeCount;
+	uint32_t indexOffset;
+	uint32_t stringCount;
+	uint32_t stringsOffset;
+	uint32_t stringDataOffset;
+	uint32_t stringDataSize;
+};
+
+struct DialogIndexEntry {
+	int32_t id;
+	uint32_t nodeOffset; // 相对于文件开头
+};
+
+struct DialogStringEntry {
+	uint32_t offset; // 相对于字符串数据
+	uint32_t length;
+};
+
+struct DialogNodeRecord {
+	int32_t id;
+	uint32_t name;
+	uint32_t text;
+	uint32_t portrait;
+	int32_t nextId;
+	uint32_t optionCount;
+};
+
+struct DialogOptionRecord {
+	uint32_t text;
+	int32_t nextId;
+};
+
+/// 解码出的节点视图，字符串直接指向脚本数据
+struct DialogNodeView {
+	int id;
+	std::string_view name;
+	std::string_view text;
+	std::string_view portrait;
+	int nextId;
+	const DialogOptionRecord* options;
+	int optionCount;
+};
+
+// ==================== 编译器 ====================
+
+static std::string TrimDialogLine(const std::string& line) {
+	size_t begin = line.find_first_not_of(" \t\r\n");
+	if (begin == std::string::npos) return "";
+	size_t end = line.find_last_not_of(" \t\r\n");
+	return line.substr(begin, end - begin + 1);
+}
+
+/// 解析节点 id：必须是正整数（0 在交互系统里表示“没有对话”）
+static bool ParseDialogId(const std::string& text, int& id) {
+	std::string trimmed = TrimDialogLine(text);
+	if (trimmed.empty()) return false;
+	char* end = nullptr;
+	long value = strtol(trimmed.c_str(), &end, 10);
+	if (*end != '\0' || value <= 0 || value > INT_MAX) return false;
+	id = (int)value;
+	return true;
+}
+
+/// 把文本脚本编译为二进制，失败时 error 中给出行号和原因
+bool CompileDialogScript(const std::string& source, std::vector<unsigned char>& out, std::string& error) {
+	struct SourceOption { uint32_t text; int nextId; };
+	struct SourceNode {
+		int id;
+		uint32_t name;
+		uint32_t portrait;
+		std::string text;
+		int nextId;
+		std::vector<SourceOption> options;
+	};
+
+	std::vector<std::string> strings;
+	std::unordered_map<std::string, uint32_t> interned;
+	auto intern = [&](const std::string& value) -> uint32_t {
+		if (value.empty()) return DIALOG_NO_STRING;
+		auto it = interned.find(value);
+		if (it != interned.end()) return it->second;
+		uint32_t index = (uint32_t)strings.size();
+		strings.push_back(value);
+		interned[value] = index;
+		return index;
+	};
+
+	std::vector<SourceNode> nodes;
+	std::unordered_set<int> ids;
+	size_t pos = 0;
+	int lineNumber = 0;
+	while (pos <= source.size()) {
+		size_t end = source.find('\n', pos);
+		if (end == std::string::npos) end = source.size();
+		std::string line = TrimDialogLine(source.substr(pos, end - pos));
+		pos = end + 1;
+		++lineNumber;
+
+		if (line.empty() || line[0] == '#') continue;
+
+		if (line[0] == '[') {
+			size_t close = line.find(']');
+			if (close == std::string::npos) {
+				error = "第 " + std::to_string(lineNumber) + " 行: 缺少 ']'";
+				return false;
+			}
+			SourceNode node;
+			if (!ParseDialogId(line.substr(1, close - 1), node.id)) {
+				error = "第 " + std::to_string(lineNumber) + " 行: 节点 id 必须是正整数: " + line.substr(0, close + 1);
+				return false;
+			}
+			node.nextId = -1;
+			if (!ids.insert(node.id).second) {
+				error = "第 " + std::to_string(lineNumber) + " 行: 重复的节点 id " + std::to_string(node.id);
+				return false;
+			}
+
+			std::string header = TrimDialogLine(line.substr(close + 1));
+			std::string portrait;
+			size_t at = header.rfind('@');
+			if (at != std::string::npos) {
+				portrait = TrimDialogLine(header.substr(at + 1));
+				header = TrimDialogLine(header.substr(0, at));
+			}
+			node.name = intern(header);
+			node.portrait = intern(portrait);
+			nodes.push_back(node);
+			continue;
+		}
+
+		if (nodes.empty()) {
+			error = "第 " + std::to_string(lineNumber) + " 行: 节点头 [id] 之前出现了内容";
+			return false;
+		}
+		SourceNode& node = nodes.back();
+
+		if (line.rfind("->", 0) == 0) {
+			if (!ParseDialogId(line.substr(2), node.nextId)) {
+				error = "第 " + std::to_string(lineNumber) + " 行: 下一个节点 id 必须是正整数: " + line;
+				return false;
+			}
+		} else if (line[0] == '*') {
+			size_t arrow = line.rfind("->");
+			if (arrow == std::string::npos) {
+				error = "第 " + std::to_string(lineNumber) + " 行: 选项缺少 '-> 目标节点'";
+				return false;
+			}
+			int target = 0;
+			if (!ParseDialogId(line.substr(arrow + 2), target)) {
+				error = "第 " + std::to_string(lineNumber) + " 行: 选项的目标节点 id 必须是正整数: " + line;
+				return false;
+			}
+			node.options.push_back({intern(TrimDialogLine(line.substr(1, arrow - 1))), target});
+		} else {
+			if (!node.text.empty()) node.text += "\n";
+			node.text += line;
+		}
+	}
+
+	std::vector<uint32_t> textIds;
+	for (const auto& node : nodes) {
+		textIds.push_back(intern(node.text));
+	}
+
+	// 计算各段偏移
+	DialogScriptHeader header;
+	memcpy(header.magic, DIALOG_SCRIPT_MAGIC, 4);
+	header.version = DIALOG_SCRIPT_VERSION;
+	header.nodeCount = (uint32_t)nodes.size();
+	header.indexOffset = sizeof(DialogScriptHeader);
+	header.stringCount = (uint32_t)strings.size();
+	header.stringsOffset = header.indexOffset + header.nodeCount * sizeof(DialogIndexEntry);
+	header.stringDataOffset = header.stringsOffset + header.stringCount * sizeof(DialogStringEntry);
+
+	std::vector<DialogStringEntry> stringEntries;
+	std::string stringData;
+	for (const auto& value : strings) {
+		stringEntries.push_back({(uint32_t)stringData.size(), (uint32_t)value.size()});
+		stringData += value;
+	}
+	header.stringDataSize = (uint32_t)stringData.size();
+	while (stringData.size() % 4) stringData += '\0';
+
+	uint32_t cursor = header.stringDataOffset + (uint32_t)stringData.size();
+	std::vector<DialogIndexEntry> index;
+	for (const auto& node : nodes) {
+		index.push_back({node.id, cursor});
+		cursor += sizeof(DialogNodeRecord) + (uint32_t)(node.options.size() * sizeof(DialogOptionRecord));
+	}
+
+	out.clear();
+	out.reserve(cursor);
+	auto append = [&out](const void* data, size_t size) {
+		const unsigned char* bytes = (const unsigned char*)data;
+		out.insert(out.end(), bytes, bytes + size);
+	};
+
+	std::vector<DialogIndexEntry> sortedIndex = index;
+	std::sort(sortedIndex.begin(), sortedIndex.end(), [](const DialogIndexEntry& a, const DialogIndexEntry& b) {
+		return a.id < b.id;
+	});
+
+	append(&header, sizeof(header));
+	append(sortedIndex.data(), sortedIndex.size() * sizeof(DialogIndexEntry));
+	append(stringEntries.data(), stringEntries.size() * sizeof(DialogStringEntry));
+	append(stringData.data(), stringData.size());
+	for (size_t i = 0; i < nodes.size(); ++i) {
+		DialogNodeRecord record = {nodes[i].id, nodes[i].name, textIds[i], nodes[i].portrait,
+			nodes[i].nextId, (uint32_t)nodes[i].options.size()};
+		append(&record, sizeof(record));
+		for (const auto& option : nodes[i].options) {
+			DialogOptionRecord optionRecord = {option.text, option.nextId};
+			append(&optionRecord, sizeof(optionRecord));
+		}
+	}
+	return true;
+}
+
+// ==================== 运行时读取 ====================
+
+class DialogScript {
+private:
+	MappedFile file;                    // 独立的 .dlgb 文件
+	PackData packed;                    // 或资源包中的条目
+	std::vector<unsigned char> compiled; // 或现场编译的文本脚本
+
+	const unsigned char* data;
+	size_t size;
+	const DialogScriptHeader* header;
+	const DialogIndexEntry* index;
+	const DialogStringEntry* strings;
+	const char* stringData;
+
+	bool Attach(const unsigned char* bytes, size_t length, const std::string& name);
+
+public:
+	DialogScript() : packed{nullptr, 0, nullptr}, data(nullptr), size(0),
+	header(nullptr), index(nullptr), strings(nullptr), stringData(nullptr) {}
+	~DialogScript() { Close(); }
+
+	DialogScript(const DialogScript&) = delete;
+	DialogScript& operator=(const DialogScript&) = delete;
+
+	bool Open(const std::string& path);
+	bool OpenSource(const std::string& path);
+	void Close();
+
+	bool IsOpen() const { return header != nullptr; }
+	int NodeCount() const { return header ? (int)header->nodeCount : 0; }
+
+	std::string_view GetString(uint32_t id) const;
+	bool Decode(int id, DialogNodeView& view) const;
+};
+
+bool DialogScript::Attach(const unsigned char* bytes, size_t length, const std::string& name) {
+	data = bytes;
+	size = length;
+	const DialogScriptHeader* h = (const DialogScriptHeader*)bytes;
+	if (!bytes || length < sizeof(DialogScriptHeader) ||
+		memcmp(h->magic, DIALOG_SCRIPT_MAGIC, 4) != 0 || h->version != DIALOG_SCRIPT_VERSION ||
+		(uint64_t)h->indexOffset + (uint64_t)h->nodeCount * sizeof(DialogIndexEntry) > length ||
+		(uint64_t)h->stringsOffset + (uint64_t)h->stringCount * sizeof(DialogStringEntry) > length ||
+		(uint64_t)h->stringDataOffset + h->stringDataSize > length) {
+		TraceLog(LOG_WARNING, "DIALOG: [%s] 不是有效的对话脚本", name.c_str());
+		Close();
+		return false;
+	}
+
+	header = h;
+	index = (const DialogIndexEntry*)(bytes + h->indexOffset);
+	strings = (const DialogStringEntry*)(bytes + h->stringsOffset);
+	stringData = (const char*)(bytes + h->stringDataOffset);
+	TraceLog(LOG_INFO, "DIALOG: [%s] %d 个节点, %d 个字符串", name.c_str(), (int)h->nodeCount, (int)h->stringCount);
+	return true;
+}
+
+/// 打开编译好的二进制脚本：优先取资源包中的条目，否则映射独立文件
+bool DialogScript::Open(const std::string& path) {
+	Close();
+	packed = assetPack.Load(path);
+	if (packed.data) {
+		return Attach(packed.data, (size_t)packed.size, path);
+	}
+	if (!file.Open(path.c_str())) return false;
+	return Attach(file.Data(), file.Size(), path);
+}
+
+/// 没有编译好的二进制时，读取文本脚本并在内存中编译
+bool DialogScript::OpenSource(const std::string& path) {
+	Close();
+	char* text = LoadFileText(path.c_str());
+	if (!text) return false;
+
+	std::string error;
+	bool ok = CompileDialogScript(text, compiled, error);
+	UnloadFileText(text);
+	if (!ok) {
+		TraceLog(LOG_WARNING, "DIALOG: [%s] %s", path.c_str(), error.c_str());
+		return false;
+	}
+	return Attach(compiled.data(), compiled.size(), path);
+}
+
+void DialogScript::Close() {
+	file.Close();
+	UnloadPackData(packed);
+	compiled.clear();
+	data = nullptr;
+	size = 0;
+	header = nullptr;
+	index = nullptr;
+	strings = nullptr;
+	stringData = nullptr;
+}
+
+std::string_view DialogScript::GetString(uint32_t id) const {
+	if (!header || id >= header->stringCount) return {};
+	const DialogStringEntry& entry = strings[id];
+	if ((uint64_t)entry.offset + entry.length > header->stringDataSize) return {};
+	return std::string_view(stringData + entry.offset, entry.length);
+}
+
+/// 按 id 解码单个节点（二分查找索引，不分配内存）
+bool DialogScript::Decode(int id, DialogNodeView& view) const {
+	if (!header) return false;
+
+	const DialogIndexEntry* begin = index;
+	const DialogIndexEntry* end = index + header->nodeCount;
+	const DialogIndexEntry* it = std::lower_bound(begin, end, id, [](const DialogIndexEntry& entry, int value) {
+		return entry.id < value;
+	});
+	if (it == end || it->id != id) return false;
+	if ((uint64_t)it->nodeOffset + sizeof(DialogNodeRecord) > size) return false;
+
+	const DialogNodeRecord* record = (const DialogNodeRecord*)(data + it->nodeOffset);
+	if ((uint64_t)it->nodeOffset + sizeof(DialogNodeRecord) +
+		(uint64_t)record->optionCount * sizeof(DialogOptionRecord) > size) return false;
+
+	view.id = record->id;
+	view.name = GetString(record->name);
+	view.text = GetString(record->text);
+	view.portrait = GetString(record->portrait);
+	view.nextId = record->nextId;
+	view.options = (const DialogOptionRecord*)(record + 1);
+	view.optionCount = (int)record->optionCount;
+	return true;
+}
+
+#endif // DIALOGSCRIPT_H
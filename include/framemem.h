@@ -0,0 +1,221 @@
+#ifndef FRAMEMEM_H
+#define FRAMEMEM_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+// ==================== 分配统计 ====================
+//
+// 替换全局 operator new，按线程统计分配次数和字节数；分析器（profiler.h）据此给出
+// 每帧、每个分析段的分配量。稳态检查开启后，预热结束的帧里主线程的任何分配都会被报告
+// （ALLOC_GUARD_WARN）或直接中止程序（ALLOC_GUARD_ABORT，便于在调试器里看到调用栈）。
+//
+// 与分析器相同，定义 NDEBUG 的发布版本中不替换 operator new；定义 NB_PROFILE 或
+// NB_ALLOC_HOOK 时保留。
+
+#if !defined(NDEBUG) || defined(NB_PROFILE) || defined(NB_ALLOC_HOOK)
+#define ALLOC_HOOK_ENABLED 1
+#else
+#define ALLOC_HOOK_ENABLED 0
+#endif
+
+enum AllocGuardMode {
+	ALLOC_GUARD_OFF,
+	ALLOC_GUARD_WARN,
+	ALLOC_GUARD_ABORT
+};
+
+struct AllocCounters {
+	uint64_t count;
+	uint64_t bytes;
+};
+
+// 只用平凡类型，operator new 在线程启动和静态初始化期间也可能被调用
+static thread_local AllocCounters allocCounters = {0, 0};
+static thread_local bool allocGuardArmed = false;      // 本线程当前帧是否处于稳态检查中
+static thread_local const char* allocScope = nullptr;  // 当前分析段，由 profiler.h 维护
+static AllocGuardMode allocGuardMode = ALLOC_GUARD_OFF;
+static int allocGuardWarmup = 600;
+
+#if ALLOC_HOOK_ENABLED
+
+static void* CountedAlloc(size_t size) {
+	++allocCounters.count;
+	allocCounters.bytes += size;
+	if (allocGuardArmed && allocGuardMode == ALLOC_GUARD_ABORT) {
+		allocGuardArmed = false;
+		fprintf(stderr, "ALLOC: 稳态帧内分配了 %zu 字节（分析段: %s）\n", size, allocScope ? allocScope : "无");
+		abort();
+	}
+	return std::malloc(size ? size : 1);
+}
+
+// 替换函数不能被内联：GCC 内联后会把 new 里的 malloc 和 delete 里的 free 配对，
+// 误报 -Wmismatched-new-delete
+#if defined(__GNUC__)
+#define ALLOC_HOOK_NOINLINE __attribute__((noinline))
+#else
+#define ALLOC_HOOK_NOINLINE
+#endif
+
+ALLOC_HOOK_NOINLINE void* operator new(size_t size) {
+	if (void* p = CountedAlloc(size)) return p;
+	throw std::bad_alloc();
+}
+
+ALLOC_HOOK_NOINLINE void* operator new[](size_t size) {
+	if (void* p = CountedAlloc(size)) return p;
+	throw std::bad_alloc();
+}
+
+ALLOC_HOOK_NOINLINE void* operator new(size_t size, const std::nothrow_t&) noexcept { return CountedAlloc(size); }
+ALLOC_HOOK_NOINLINE void* operator new[](size_t size, const std::nothrow_t&) noexcept { return CountedAlloc(size); }
+ALLOC_HOOK_NOINLINE void operator delete(void* p) noexcept { std::free(p); }
+ALLOC_HOOK_NOINLINE void operator delete[](void* p) noexcept { std::free(p); }
+ALLOC_HOOK_NOINLINE void operator delete(void* p, size_t) noexcept { std::free(p); }
+ALLOC_HOOK_NOINLINE void operator delete[](void* p, size_t) noexcept { std::free(p); }
+ALLOC_HOOK_NOINLINE void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+ALLOC_HOOK_NOINLINE void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+#endif // ALLOC_HOOK_ENABLED
+
+/// 本线程累计的分配（关闭统计时恒为 0）
+AllocCounters GetAllocCounters() {
+	return allocCounters;
+}
+
+/// 开启稳态检查：前 warmupFrames 帧不检查（回溯缓冲等在写满一圈之前会分配）
+void SetAllocationGuard(AllocGuardMode mode, int warmupFrames = 600) {
+	allocGuardMode = mode;
+	allocGuardWarmup = warmupFrames < 0 ? 0 : warmupFrames;
+}
+
+/// 解析命令行: --alloc-guard 报告稳态帧中的分配，--alloc-guard=abort 遇到即中止
+void InitAllocationGuard(int argc, char** argv) {
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "--alloc-guard") == 0) SetAllocationGuard(ALLOC_GUARD_WARN);
+		else if (strcmp(argv[i], "--alloc-guard=abort") == 0) SetAllocationGuard(ALLOC_GUARD_ABORT);
+	}
+}
+
+/// 本帧的分配是预期的（开始对话、加载区域、存档等一次性事件），不计为稳态违规
+void AllowFrameAllocations() {
+	allocGuardArmed = false;
+}
+
+// ==================== 帧内线性分配器 ====================
+//
+// 只在主线程使用。每帧开头 ResetFrameArena 整体回收，分配只移动指针、释放为空操作，
+// 适合帧内临时的字符串和数组。本帧用量超出容量时临时向堆申请，下一帧开头按最高用量扩容，
+// 此后稳态帧不再有堆分配。
+
+class FrameArena {
+private:
+	unsigned char* block;
+	size_t capacity;
+	size_t used;
+	size_t highWater;
+	std::vector<unsigned char*> overflow; // 容量不足时临时申请的块，Reset 时释放
+
+public:
+	explicit FrameArena(size_t initialCapacity = 64 * 1024)
+	: block(nullptr), capacity(initialCapacity), used(0), highWater(0) {}
+	~FrameArena() {
+		Reset();
+		delete[] block;
+	}
+
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+
+	void* Allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+		if (!block) block = new unsigned char[capacity];
+		size_t start = (used + align - 1) & ~(align - 1);
+		if (start + size <= capacity) {
+			used = start + size;
+			if (used > highWater) highWater = used;
+			return block + start;
+		}
+		highWater = start + size > highWater ? start + size : highWater;
+		used = highWater; // 记下需求，下一帧扩容
+		unsigned char* chunk = new unsigned char[size + align];
+		overflow.push_back(chunk);
+		return (void*)(((uintptr_t)chunk + align - 1) & ~(uintptr_t)(align - 1));
+	}
+
+	void Reset() {
+		for (unsigned char* chunk : overflow) delete[] chunk;
+		overflow.clear();
+		if (highWater > capacity && block) {
+			delete[] block;
+			capacity = highWater + highWater / 2;
+			block = new unsigned char[capacity];
+		}
+		used = 0;
+	}
+
+	size_t Used() const { return used; }
+	size_t Capacity() const { return capacity; }
+	size_t HighWater() const { return highWater; }
+};
+
+static FrameArena frameArena;
+
+void* FrameAlloc(size_t size, size_t align = alignof(std::max_align_t)) {
+	return frameArena.Allocate(size, align);
+}
+
+/// 每帧开头调用一次，回收上一帧的全部临时分配
+void ResetFrameArena() {
+	frameArena.Reset();
+}
+
+/// 供标准容器使用的帧内分配器（内容只在当前帧有效）
+template<typename T>
+struct FrameAllocator {
+	typedef T value_type;
+
+	FrameAllocator() = default;
+	template<typename U>
+	FrameAllocator(const FrameAllocator<U>&) {}
+
+	T* allocate(size_t n) { return (T*)FrameAlloc(n * sizeof(T), alignof(T)); }
+	void deallocate(T*, size_t) {}
+
+	template<typename U>
+	bool operator==(const FrameAllocator<U>&) const { return true; }
+	template<typename U>
+	bool operator!=(const FrameAllocator<U>&) const { return false; }
+};
+
+template<typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+typedef std::basic_string<char, std::char_traits<char>, FrameAllocator<char>> FrameString;
+
+/// 格式化到帧内存，长度不受限制，结果只在当前帧有效
+const char* FrameFormat(const char* format, ...) {
+	va_list args;
+	va_start(args, format);
+	va_list copy;
+	va_copy(copy, args);
+	int length = vsnprintf(nullptr, 0, format, copy);
+	va_end(copy);
+
+	char* text = (char*)FrameAlloc(length > 0 ? length + 1 : 1, 1);
+	if (length > 0) {
+		vsnprintf(text, length + 1, format, args);
+	} else {
+		text[0] = '\0';
+	}
+	va_end(args);
+	return text;
+}
+
+#endif // FRAMEMEM_H
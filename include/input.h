@@ -0,0 +1,313 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include "raylib.h"
+#include "savefile.h"
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+
+// ==================== 输入层 ====================
+//
+// 游戏逻辑统一通过 InputDown / InputPressed 读取按键，通过 GetInputDeltaTime 读取帧间隔，
+// 不再直接调用 raylib。这样同一套逻辑可以：
+//   实时游玩   按键来自 raylib，帧间隔为真实帧时间
+//   录制       按键来自 raylib，帧间隔固定为 fixedStep，每个 tick 的按键状态写入文件
+//   回放       按键来自文件，帧间隔固定，不限帧率，比实时更快地重现同一局
+//
+// 录像文件:
+// [InputFileHeader]
+// [按键码 int32 x keyCount]   录制时的按键表，回放时按键码对应，按键表变化不影响旧录像
+// [InputRun x runCount]       游程编码: 连续 ticks 个 tick 的按下状态都是 down
+
+static const char INPUT_MAGIC[4] = {'N', 'B', 'I', 'N'};
+static const uint32_t INPUT_VERSION = 1;
+
+// 录制的按键（最多 64 个，每个占 down 的一位）
+static const int INPUT_KEYS[] = {
+	KEY_W, KEY_A, KEY_S, KEY_D, KEY_UP, KEY_DOWN, KEY_LEFT, KEY_RIGHT,
+	KEY_SPACE, KEY_E, KEY_F, KEY_O, KEY_C, KEY_R, KEY_ONE, KEY_TWO,
+	KEY_F1, KEY_F5, KEY_F9, KEY_BACKSPACE, KEY_ENTER
+};
+static const int INPUT_KEY_COUNT = (int)(sizeof(INPUT_KEYS) / sizeof(INPUT_KEYS[0]));
+
+struct InputFileHeader {
+	char magic[4];
+	uint32_t version;
+	uint32_t keyCount;
+	uint32_t runCount;
+	uint32_t tickCount;
+	float fixedStep;
+	uint32_t checksum; // 按键表和游程数据的校验
+};
+
+struct InputRun {
+	uint32_t ticks;
+	uint64_t down;
+};
+
+enum class InputMode { LIVE, RECORDING, REPLAYING };
+
+static InputMode inputMode = InputMode::LIVE;
+static signed char inputKeySlot[512];       // 按键码 -> 位序号，-1 表示不录制
+static bool inputSlotsReady = false;
+static uint64_t inputDown = 0;
+static uint64_t inputPrevDown = 0;
+static float inputStep = 1.0f / 60.0f;
+static float inputDelta = 0.0f;
+static double inputClock = 0.0;
+static uint64_t inputTick = 0;
+
+static std::vector<InputRun> inputRuns;
+static std::string inputRecordPath;
+static size_t inputRunIndex = 0;
+static uint32_t inputRunUsed = 0;
+static bool inputReplayDone = false;
+static double inputReplayStart = 0.0;
+static uint64_t inputReplayFirstTick = 0;
+static double inputFrameStart = 0.0;
+static double inputWorstFrame = 0.0;
+
+static void BuildInputSlots() {
+	if (inputSlotsReady) return;
+	memset(inputKeySlot, -1, sizeof(inputKeySlot));
+	for (int i = 0; i < INPUT_KEY_COUNT; ++i) {
+		inputKeySlot[INPUT_KEYS[i]] = (signed char)i;
+	}
+	inputSlotsReady = true;
+}
+
+static int InputSlot(int key) {
+	return key >= 0 && key < (int)sizeof(inputKeySlot) ? inputKeySlot[key] : -1;
+}
+
+/// 开始录制，之后每个 tick 的帧间隔固定为 fixedStep
+bool StartInputRecording(const std::string& path, float fixedStep = 1.0f / 60.0f) {
+	BuildInputSlots();
+	inputMode = InputMode::RECORDING;
+	inputRecordPath = path;
+	inputStep = fixedStep > 0 ? fixedStep : 1.0f / 60.0f;
+	inputRuns.clear();
+	TraceLog(LOG_INFO, "INPUT: 开始录制 [%s]", path.c_str());
+	return true;
+}
+
+/// 结束录制并写出录像文件
+bool StopInputRecording() {
+	if (inputMode != InputMode::RECORDING) return false;
+	inputMode = InputMode::LIVE;
+
+	InputFileHeader header;
+	memcpy(header.magic, INPUT_MAGIC, 4);
+	header.version = INPUT_VERSION;
+	header.keyCount = (uint32_t)INPUT_KEY_COUNT;
+	header.runCount = (uint32_t)inputRuns.size();
+	header.tickCount = 0;
+	for (const auto& run : inputRuns) header.tickCount += run.ticks;
+	header.fixedStep = inputStep;
+
+	std::vector<unsigned char> body(INPUT_KEY_COUNT * sizeof(int32_t) + inputRuns.size() * sizeof(InputRun));
+	for (int i = 0; i < INPUT_KEY_COUNT; ++i) {
+		int32_t key = INPUT_KEYS[i];
+		memcpy(body.data() + i * sizeof(int32_t), &key, sizeof(key));
+	}
+	if (!inputRuns.empty()) {
+		memcpy(body.data() + INPUT_KEY_COUNT * sizeof(int32_t), inputRuns.data(), inputRuns.size() * sizeof(InputRun));
+	}
+	header.checksum = SaveChecksum(body.data(), body.size());
+
+	std::vector<unsigned char> file(sizeof(header) + body.size());
+	memcpy(file.data(), &header, sizeof(header));
+	memcpy(file.data() + sizeof(header), body.data(), body.size());
+	bool ok = WriteFileAtomic(inputRecordPath, file.data(), file.size());
+	TraceLog(ok ? LOG_INFO : LOG_WARNING, "INPUT: 录像 [%s] %s，%u 帧，%u 段",
+	         inputRecordPath.c_str(), ok ? "已保存" : "写入失败", header.tickCount, header.runCount);
+	inputRuns.clear();
+	return ok;
+}
+
+/// 读取录像并开始回放，按键码映射到当前的按键表
+bool StartInputReplay(const std::string& path) {
+	BuildInputSlots();
+	int size = 0;
+	unsigned char* data = LoadFileData(path.c_str(), &size);
+	if (!data) return false;
+
+	InputFileHeader header;
+	bool valid = size >= (int)sizeof(header);
+	if (valid) {
+		memcpy(&header, data, sizeof(header));
+		valid = memcmp(header.magic, INPUT_MAGIC, 4) == 0 && header.version == INPUT_VERSION &&
+		        header.keyCount <= 64 && header.fixedStep > 0 &&
+		        (uint64_t)sizeof(header) + header.keyCount * sizeof(int32_t) +
+		        (uint64_t)header.runCount * sizeof(InputRun) == (uint64_t)size;
+	}
+	if (valid) {
+		valid = SaveChecksum(data + sizeof(header), size - sizeof(header)) == header.checksum;
+	}
+	if (!valid) {
+		UnloadFileData(data);
+		TraceLog(LOG_WARNING, "INPUT: 录像 [%s] 无效或已损坏", path.c_str());
+		return false;
+	}
+
+	// 录像里第 i 位对应的按键 -> 当前按键表的位
+	int remap[64];
+	for (uint32_t i = 0; i < header.keyCount; ++i) {
+		int32_t key = 0;
+		memcpy(&key, data + sizeof(header) + i * sizeof(int32_t), sizeof(key));
+		remap[i] = InputSlot(key);
+	}
+
+	const unsigned char* runs = data + sizeof(header) + header.keyCount * sizeof(int32_t);
+	inputRuns.resize(header.runCount);
+	for (uint32_t r = 0; r < header.runCount; ++r) {
+		InputRun run;
+		memcpy(&run, runs + r * sizeof(InputRun), sizeof(run));
+		uint64_t down = 0;
+		for (uint32_t i = 0; i < header.keyCount; ++i) {
+			if (((run.down >> i) & 1) && remap[i] >= 0) down |= 1ull << remap[i];
+		}
+		inputRuns[r] = {run.ticks, down};
+	}
+	UnloadFileData(data);
+
+	inputMode = InputMode::REPLAYING;
+	inputStep = header.fixedStep;
+	inputRunIndex = 0;
+	inputRunUsed = 0;
+	inputReplayDone = false;
+	inputReplayStart = GetTime();
+	inputReplayFirstTick = inputTick;
+	inputFrameStart = inputReplayStart;
+	inputWorstFrame = 0.0;
+	TraceLog(LOG_INFO, "INPUT: 开始回放 [%s]，%u 帧", path.c_str(), header.tickCount);
+	return true;
+}
+
+/// 解析命令行: --record <文件> 录制，--replay <文件> 回放（默认不限帧率，加 --realtime 按原速）
+void InitInput(int argc, char** argv) {
+	BuildInputSlots();
+	bool realtime = false;
+	std::string record;
+	std::string replay;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--record" && i + 1 < argc) record = argv[++i];
+		else if (arg == "--replay" && i + 1 < argc) replay = argv[++i];
+		else if (arg == "--realtime") realtime = true;
+	}
+
+	if (!replay.empty()) {
+		if (StartInputReplay(replay) && !realtime) SetTargetFPS(0);
+	} else if (!record.empty()) {
+		StartInputRecording(record);
+	}
+}
+
+/// 每个 tick 开始时调用一次：采样或回放按键。回放结束时返回 false
+bool BeginInputFrame() {
+	BuildInputSlots();
+	inputPrevDown = inputDown;
+
+	if (inputMode == InputMode::REPLAYING) {
+		double now = GetTime();
+		uint64_t played = inputTick - inputReplayFirstTick;
+		if (played > 0 && now - inputFrameStart > inputWorstFrame) inputWorstFrame = now - inputFrameStart;
+		inputFrameStart = now;
+
+		while (inputRunIndex < inputRuns.size() && inputRunUsed >= inputRuns[inputRunIndex].ticks) {
+			++inputRunIndex;
+			inputRunUsed = 0;
+		}
+		if (inputRunIndex >= inputRuns.size()) {
+			if (!inputReplayDone) {
+				double elapsed = now - inputReplayStart;
+				TraceLog(LOG_INFO, "INPUT: 回放结束，%llu 帧，用时 %.2f 秒，平均 %.3f ms/帧，最慢 %.3f ms",
+				         (unsigned long long)played, elapsed,
+				         played ? elapsed * 1000.0 / played : 0.0, inputWorstFrame * 1000.0);
+			}
+			inputReplayDone = true;
+			inputDown = 0;
+			return false;
+		}
+		inputDown = inputRuns[inputRunIndex].down;
+		++inputRunUsed;
+		inputDelta = inputStep;
+	} else {
+		inputDown = 0;
+		for (int i = 0; i < INPUT_KEY_COUNT; ++i) {
+			if (IsKeyDown(INPUT_KEYS[i])) inputDown |= 1ull << i;
+		}
+
+		if (inputMode == InputMode::RECORDING) {
+			if (!inputRuns.empty() && inputRuns.back().down == inputDown && inputRuns.back().ticks < UINT32_MAX) {
+				++inputRuns.back().ticks;
+			} else {
+				inputRuns.push_back({1, inputDown});
+			}
+			inputDelta = inputStep;
+		} else {
+			inputDelta = GetFrameTime();
+		}
+	}
+
+	inputClock += inputDelta;
+	++inputTick;
+	return true;
+}
+
+/// 退出前调用：录制中则写出录像
+void UnloadInput() {
+	if (inputMode == InputMode::RECORDING) StopInputRecording();
+	inputMode = InputMode::LIVE;
+	inputRuns.clear();
+}
+
+bool InputDown(int key) {
+	int slot = InputSlot(key);
+	if (slot < 0) return inputMode != InputMode::REPLAYING && IsKeyDown(key); // 不在按键表中的键不参与录制
+	return (inputDown >> slot) & 1;
+}
+
+bool InputPressed(int key) {
+	int slot = InputSlot(key);
+	if (slot < 0) return inputMode != InputMode::REPLAYING && IsKeyPressed(key);
+	return ((inputDown & ~inputPrevDown) >> slot) & 1;
+}
+
+bool InputReleased(int key) {
+	int slot = InputSlot(key);
+	if (slot < 0) return inputMode != InputMode::REPLAYING && IsKeyReleased(key);
+	return ((~inputDown & inputPrevDown) >> slot) & 1;
+}
+
+/// 本 tick 的帧间隔（录制和回放时为固定步长）
+float GetInputDeltaTime() {
+	return inputDelta;
+}
+
+/// 游戏时钟：各 tick 帧间隔之和，回放时与录制时完全一致
+double GetInputTime() {
+	return inputClock;
+}
+
+uint64_t GetInputTick() {
+	return inputTick;
+}
+
+bool IsInputRecording() {
+	return inputMode == InputMode::RECORDING;
+}
+
+bool IsInputReplaying() {
+	return inputMode == InputMode::REPLAYING;
+}
+
+/// 录制和回放都按固定步长运行，需要结果可复现的系统（如异步加载）应同步等待
+bool IsInputDeterministic() {
+	return inputMode != InputMode::LIVE;
+}
+
+#endif // INPUT_H
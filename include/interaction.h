@@ -0,0 +1,331 @@
+#ifndef INTERACTION_H
+#define INTERACTION_H
+
+#include "raylib.h"
+#include "profiler.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// ==================== 交互与触发区 ====================
+//
+// 可交互点（NPC、告示牌）和触发区（草丛、金币、剧情区域）登记在同一个系统里，按均匀网格建立
+// 空间索引：可交互点放进所在的格子，触发区放进覆盖到的每个格子。每次查询只访问玩家附近的
+// 几个格子，与场景里登记的总数无关。
+//
+// 每一项绑定一个对话起点编号（0 表示没有）和一个事件名，由调用方决定怎么处理：
+//   int target = interactions.FindNearestInteractable(center, 0.0f);
+//   if (target >= 0 && InputPressed(KEY_F)) dialogSystem.StartDialog(interactions.GetInteractable(target).dialogId);
+//   interactions.UpdateTriggers(player.GetCollisionBox());
+//   for (int trigger : interactions.GetEnteredTriggers()) { ... }
+//
+// owner 与 CollisionSystem 的相同，流式加载的区域卸载时按 owner 一起移除。
+
+struct Interactable {
+	Vector2 position;
+	float reach;       // 玩家与它的距离不超过 查询半径 + reach 时可以交互
+	int dialogId;      // 对话起点，0 表示没有
+	std::string event; // 事件名，由调用方解释
+	int owner;
+	bool enabled;
+	bool active;       // 槽位在用
+};
+
+struct TriggerVolume {
+	Rectangle rect;
+	int dialogId;
+	std::string event;
+	int owner;
+	bool enabled;
+	bool active;
+	bool inside;       // 上一次 UpdateTriggers 时在里面
+	uint32_t stamp;    // 本次查询中与玩家相交（触发区可能出现在多个格子里，避免重复报告）
+};
+
+class InteractionSystem {
+private:
+	float cellSize;
+	float maxReach; // 所有可交互点里最大的 reach，决定查询要外扩多少
+	std::vector<Interactable> interactables;
+	std::vector<TriggerVolume> triggers;
+	std::vector<int> freeInteractables;
+	std::vector<int> freeTriggers;
+	std::unordered_map<int64_t, std::vector<int>> interactableCells;
+	std::unordered_map<int64_t, std::vector<int>> triggerCells;
+	std::vector<int> insideTriggers; // 上一次查询时在里面的触发区
+	std::vector<int> nextInside;
+	std::vector<int> entered;
+	std::vector<int> exited;
+	uint32_t queryStamp;
+
+	static int64_t Key(int x, int y) { return (int64_t)(((uint64_t)(uint32_t)x << 32) | (uint32_t)y); }
+	int CellOf(float value) const { return (int)std::floor(value / cellSize); }
+
+	static void EraseFromCell(std::unordered_map<int64_t, std::vector<int>>& cells, int64_t key, int handle);
+	void IndexTrigger(int handle);
+	void UnindexTrigger(int handle);
+
+public:
+	explicit InteractionSystem(float gridCellSize = 128.0f);
+
+	// 可交互点：返回句柄
+	int AddInteractable(Vector2 position, float reach, int dialogId, const std::string& event = "", int owner = 0);
+	void MoveInteractable(int handle, Vector2 position); // 会走动的 NPC 每帧更新位置
+	void RemoveInteractable(int handle);
+
+	// 触发区：返回句柄
+	int AddTrigger(const Rectangle& rect, int dialogId, const std::string& event = "", int owner = 0);
+	void RemoveTrigger(int handle);
+	void SetTriggerEnabled(int handle, bool enabled); // 停用后不再报告进入，重新启用时视为在外面
+
+	void SetInteractableEnabled(int handle, bool enabled);
+	void RemoveOwner(int owner); // 移除某个区域的全部登记项
+	void Clear();
+
+	/// position 周围 radius 内（加上各自的 reach）最近的可交互点，没有时返回 -1
+	int FindNearestInteractable(Vector2 position, float radius) const;
+
+	/// 每个 tick 用玩家的碰撞箱调用一次，之后可取本次进入/离开的触发区
+	void UpdateTriggers(const Rectangle& actor);
+	const std::vector<int>& GetEnteredTriggers() const { return entered; }
+	const std::vector<int>& GetExitedTriggers() const { return exited; }
+	bool IsInsideTrigger(int handle) const { return triggers[handle].inside; }
+
+	const Interactable& GetInteractable(int handle) const { return interactables[handle]; }
+	const TriggerVolume& GetTrigger(int handle) const { return triggers[handle]; }
+
+	void DrawDebug(const Rectangle& view) const;
+};
+
+// ==================== InteractionSystem 实现 ====================
+
+InteractionSystem::InteractionSystem(float gridCellSize)
+: cellSize(gridCellSize > 1.0f ? gridCellSize : 1.0f), maxReach(0.0f), queryStamp(0) {}
+
+void InteractionSystem::EraseFromCell(std::unordered_map<int64_t, std::vector<int>>& cells, int64_t key, int handle) {
+	auto cell = cells.find(key);
+	if (cell == cells.end()) return;
+	std::vector<int>& list = cell->second;
+	auto it = std::find(list.begin(), list.end(), handle);
+	if (it != list.end()) {
+		*it = list.back();
+		list.pop_back();
+	}
+	if (list.empty()) cells.erase(cell);
+}
+
+int InteractionSystem::AddInteractable(Vector2 position, float reach, int dialogId, const std::string& event, int owner) {
+	int handle;
+	if (!freeInteractables.empty()) {
+		handle = freeInteractables.back();
+		freeInteractables.pop_back();
+	} else {
+		handle = (int)interactables.size();
+		interactables.emplace_back();
+	}
+	Interactable& entry = interactables[handle];
+	entry.position = position;
+	entry.reach = reach > 0.0f ? reach : 0.0f;
+	entry.dialogId = dialogId;
+	entry.event = event;
+	entry.owner = owner;
+	entry.enabled = true;
+	entry.active = true;
+	maxReach = std::max(maxReach, entry.reach);
+	interactableCells[Key(CellOf(position.x), CellOf(position.y))].push_back(handle);
+	return handle;
+}
+
+void InteractionSystem::MoveInteractable(int handle, Vector2 position) {
+	Interactable& entry = interactables[handle];
+	int64_t from = Key(CellOf(entry.position.x), CellOf(entry.position.y));
+	int64_t to = Key(CellOf(position.x), CellOf(position.y));
+	entry.position = position;
+	if (from == to) return;
+	EraseFromCell(interactableCells, from, handle);
+	interactableCells[to].push_back(handle);
+}
+
+void InteractionSystem::RemoveInteractable(int handle) {
+	Interactable& entry = interactables[handle];
+	if (!entry.active) return;
+	EraseFromCell(interactableCells, Key(CellOf(entry.position.x), CellOf(entry.position.y)), handle);
+	entry.active = false;
+	entry.event.clear();
+	freeInteractables.push_back(handle);
+}
+
+void InteractionSystem::SetInteractableEnabled(int handle, bool enabled) {
+	interactables[handle].enabled = enabled;
+}
+
+void InteractionSystem::IndexTrigger(int handle) {
+	const Rectangle& rect = triggers[handle].rect;
+	for (int y = CellOf(rect.y); y <= CellOf(rect.y + rect.height); ++y) {
+		for (int x = CellOf(rect.x); x <= CellOf(rect.x + rect.width); ++x) {
+			triggerCells[Key(x, y)].push_back(handle);
+		}
+	}
+}
+
+void InteractionSystem::UnindexTrigger(int handle) {
+	const Rectangle& rect = triggers[handle].rect;
+	for (int y = CellOf(rect.y); y <= CellOf(rect.y + rect.height); ++y) {
+		for (int x = CellOf(rect.x); x <= CellOf(rect.x + rect.width); ++x) {
+			EraseFromCell(triggerCells, Key(x, y), handle);
+		}
+	}
+}
+
+int InteractionSystem::AddTrigger(const Rectangle& rect, int dialogId, const std::string& event, int owner) {
+	int handle;
+	if (!freeTriggers.empty()) {
+		handle = freeTriggers.back();
+		freeTriggers.pop_back();
+	} else {
+		handle = (int)triggers.size();
+		triggers.emplace_back();
+	}
+	TriggerVolume& entry = triggers[handle];
+	entry.rect = rect;
+	entry.dialogId = dialogId;
+	entry.event = event;
+	entry.owner = owner;
+	entry.enabled = true;
+	entry.active = true;
+	entry.inside = false;
+	entry.stamp = 0;
+	IndexTrigger(handle);
+	return handle;
+}
+
+void InteractionSystem::RemoveTrigger(int handle) {
+	TriggerVolume& entry = triggers[handle];
+	if (!entry.active) return;
+	UnindexTrigger(handle);
+	if (entry.inside) {
+		insideTriggers.erase(std::remove(insideTriggers.begin(), insideTriggers.end(), handle), insideTriggers.end());
+	}
+	entry.active = false;
+	entry.inside = false;
+	entry.event.clear();
+	freeTriggers.push_back(handle);
+}
+
+void InteractionSystem::SetTriggerEnabled(int handle, bool enabled) {
+	TriggerVolume& entry = triggers[handle];
+	entry.enabled = enabled;
+	if (!enabled && entry.inside) {
+		entry.inside = false;
+		insideTriggers.erase(std::remove(insideTriggers.begin(), insideTriggers.end(), handle), insideTriggers.end());
+	}
+}
+
+void InteractionSystem::RemoveOwner(int owner) {
+	for (int i = 0; i < (int)interactables.size(); ++i) {
+		if (interactables[i].active && interactables[i].owner == owner) RemoveInteractable(i);
+	}
+	for (int i = 0; i < (int)triggers.size(); ++i) {
+		if (triggers[i].active && triggers[i].owner == owner) RemoveTrigger(i);
+	}
+}
+
+void InteractionSystem::Clear() {
+	interactables.clear();
+	triggers.clear();
+	freeInteractables.clear();
+	freeTriggers.clear();
+	interactableCells.clear();
+	triggerCells.clear();
+	insideTriggers.clear();
+	entered.clear();
+	exited.clear();
+	maxReach = 0.0f;
+}
+
+int InteractionSystem::FindNearestInteractable(Vector2 position, float radius) const {
+	float range = radius + maxReach;
+	int best = -1;
+	float bestDistance = 0.0f;
+	for (int y = CellOf(position.y - range); y <= CellOf(position.y + range); ++y) {
+		for (int x = CellOf(position.x - range); x <= CellOf(position.x + range); ++x) {
+			auto cell = interactableCells.find(Key(x, y));
+			if (cell == interactableCells.end()) continue;
+			for (int handle : cell->second) {
+				const Interactable& entry = interactables[handle];
+				if (!entry.enabled) continue;
+				float dx = entry.position.x - position.x;
+				float dy = entry.position.y - position.y;
+				float distance = std::sqrt(dx * dx + dy * dy);
+				if (distance > radius + entry.reach) continue;
+				if (best < 0 || distance < bestDistance) {
+					best = handle;
+					bestDistance = distance;
+				}
+			}
+		}
+	}
+	return best;
+}
+
+void InteractionSystem::UpdateTriggers(const Rectangle& actor) {
+	PROFILE_SCOPE("triggers");
+	entered.clear();
+	exited.clear();
+	nextInside.clear();
+	++queryStamp;
+
+	// 1. 玩家覆盖到的格子里，与玩家相交的触发区
+	for (int y = CellOf(actor.y); y <= CellOf(actor.y + actor.height); ++y) {
+		for (int x = CellOf(actor.x); x <= CellOf(actor.x + actor.width); ++x) {
+			auto cell = triggerCells.find(Key(x, y));
+			if (cell == triggerCells.end()) continue;
+			for (int handle : cell->second) {
+				TriggerVolume& entry = triggers[handle];
+				if (entry.stamp == queryStamp) continue;
+				if (!entry.enabled || !CheckCollisionRecs(actor, entry.rect)) continue;
+				entry.stamp = queryStamp;
+				nextInside.push_back(handle);
+				if (!entry.inside) {
+					entry.inside = true;
+					entered.push_back(handle);
+				}
+			}
+		}
+	}
+
+	// 2. 上次在里面、这次没有碰到的就是离开
+	for (int handle : insideTriggers) {
+		TriggerVolume& entry = triggers[handle];
+		if (entry.stamp == queryStamp) continue;
+		entry.inside = false;
+		exited.push_back(handle);
+	}
+	insideTriggers.swap(nextInside);
+}
+
+void InteractionSystem::DrawDebug(const Rectangle& view) const {
+	for (int y = CellOf(view.y); y <= CellOf(view.y + view.height); ++y) {
+		for (int x = CellOf(view.x); x <= CellOf(view.x + view.width); ++x) {
+			auto triggerCell = triggerCells.find(Key(x, y));
+			if (triggerCell != triggerCells.end()) {
+				for (int handle : triggerCell->second) {
+					const TriggerVolume& entry = triggers[handle];
+					DrawRectangleLinesEx(entry.rect, 2.0f, Fade(entry.inside ? ORANGE : GOLD, entry.enabled ? 0.9f : 0.3f));
+				}
+			}
+			auto interactableCell = interactableCells.find(Key(x, y));
+			if (interactableCell != interactableCells.end()) {
+				for (int handle : interactableCell->second) {
+					const Interactable& entry = interactables[handle];
+					DrawCircleLines((int)entry.position.x, (int)entry.position.y, entry.reach, Fade(LIME, entry.enabled ? 0.9f : 0.3f));
+				}
+			}
+		}
+	}
+}
+
+#endif // INTERACTION_H
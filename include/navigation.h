@@ -0,0 +1,785 @@
+#ifndef NAVIGATION_H
+#define NAVIGATION_H
+
+#include "raylib.h"
+#include "character.h"
+#include "input.h"
+#include "profiler.h"
+#include <vector>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cfloat>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// ==================== 寻路网格 ====================
+//
+// 把世界的一块矩形区域划分为 cellSize 大小的格子。格子被实体碰撞箱挡住（碰撞箱向外扩
+// agentRadius，使角色中心沿路径走时脚不会蹭到墙）就标记为不可通行。阻挡来源：
+//   - CollisionSystem 中的实体碰撞箱
+//   - GameObjectSystem 中 ImageObject 的实体碰撞箱（视为静态物体，加入后不再移动）
+// 两个系统记录碰撞箱的增删（GeometryChanges；ImageObject 的纹理在加入后才就绪时也会记录），
+// NavigationSystem::Update 只重建变化区域内的格子，并作废经过这些区域的缓存路径。
+// 重建时通过两个系统的网格索引只取与变化区域相交的碰撞箱。
+//
+// ==================== 路径服务 ====================
+//
+// RequestPath 立即返回句柄，请求排队，在 Update 中按每帧时间预算做 A* 搜索（8 方向，
+// 不穿墙角），一次搜索可以跨越多帧。结果按 (起点格, 终点格) 缓存，多个 NPC 请求同一对格子
+// 共享一份结果。几何变化使路径失效时句柄状态变为 STALE，持有者重新请求即可。
+// 录制/回放输入时按固定的扩展节点数而不是时间分片，路径完成的 tick 可以复现。
+//
+// ==================== 流场 ====================
+//
+// 大量角色走向同一个目标时不逐个做 A*：RequestFlowField 对目标格做一次全图 Dijkstra，
+// 得到每个格子到目标的距离和下一步方向，角色每 tick 用 FlowField::Sample 按所在格子 O(1)
+// 查方向。流场按目标格缓存；几何变化后自动重新计算，新结果算好之前继续使用旧的。
+// StartFlowWorkers 开启后台线程计算（工作线程只读网格快照）；没有工作线程时在 Update 里
+// 同步计算，每帧最多一个。
+
+// 8 个邻居方向：前 4 个直走，后 4 个斜走
+static const int NAV_DX[8] = {1, -1, 0, 0, 1, 1, -1, -1};
+static const int NAV_DY[8] = {0, 0, 1, -1, 1, -1, 1, -1};
+static const float NAV_COST[8] = {1, 1, 1, 1, 1.41421356f, 1.41421356f, 1.41421356f, 1.41421356f};
+static const uint8_t FLOW_NONE = 8; // 目标格或不可达
+
+enum class PathStatus {
+	PENDING, // 排队或搜索中
+	READY,   // points 可用
+	FAILED,  // 不可达（或起终点在网格外、终点被挡住）
+	STALE    // 几何变化后已作废，需要重新请求
+};
+
+struct NavPath {
+	PathStatus status = PathStatus::PENDING;
+	std::vector<Vector2> points; // 拐点（世界坐标，格子中心），不含起点，最后一个是终点
+	int startCell = -1;
+	int goalCell = -1;
+	int minX = 0, minY = 0, maxX = -1, maxY = -1; // 路径经过的格子范围
+
+	bool IsDone() const { return status != PathStatus::PENDING; }
+};
+
+typedef std::shared_ptr<NavPath> PathHandle;
+
+/// 某个目标的一份流场结果（算好后只读，可在线程间共享）
+struct FlowFieldData {
+	Rectangle area;
+	float cellSize;
+	int width;
+	int height;
+	int goalCell;
+	std::vector<float> distance;    // 到目标的路程（格），不可达为 FLT_MAX
+	std::vector<uint8_t> direction; // 下一步走向的邻居编号，FLOW_NONE 表示没有
+};
+
+/// 计算流场（线程安全，只读 blocked）；heap 为调用方复用的临时空间
+void BuildFlowFieldData(FlowFieldData& field, const std::vector<uint8_t>& blocked,
+                        std::vector<std::pair<float, int>>& heap) {
+	const int width = field.width;
+	const int height = field.height;
+	const size_t count = (size_t)width * height;
+	field.distance.assign(count, FLT_MAX);
+	field.direction.assign(count, FLOW_NONE);
+	if (field.goalCell < 0 || (size_t)field.goalCell >= count || blocked[field.goalCell]) return;
+
+	// 1. 从目标出发的 Dijkstra（与 A* 相同的走法：8 方向，不切墙角）
+	auto cmp = [](const std::pair<float, int>& a, const std::pair<float, int>& b) { return a.first > b.first; };
+	heap.clear();
+	field.distance[field.goalCell] = 0.0f;
+	heap.push_back({0.0f, field.goalCell});
+	while (!heap.empty()) {
+		std::pop_heap(heap.begin(), heap.end(), cmp);
+		auto [d, cell] = heap.back();
+		heap.pop_back();
+		if (d > field.distance[cell]) continue;
+
+		int x = cell % width;
+		int y = cell / width;
+		for (int i = 0; i < 8; ++i) {
+			int nx = x + NAV_DX[i];
+			int ny = y + NAV_DY[i];
+			if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+			int next = ny * width + nx;
+			if (blocked[next]) continue;
+			if (i >= 4 && (blocked[y * width + nx] || blocked[ny * width + x])) continue;
+			float nd = d + NAV_COST[i];
+			if (nd < field.distance[next]) {
+				field.distance[next] = nd;
+				heap.push_back({nd, next});
+				std::push_heap(heap.begin(), heap.end(), cmp);
+			}
+		}
+	}
+
+	// 2. 每个格子指向距离最小的邻居；被挡住的格子（角色被挤进墙边时）也指向最近的可走格子
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x) {
+			int cell = y * width + x;
+			if (cell == field.goalCell) continue;
+			bool inWall = blocked[cell] != 0;
+			float best = inWall ? FLT_MAX : field.distance[cell];
+			for (int i = 0; i < 8; ++i) {
+				int nx = x + NAV_DX[i];
+				int ny = y + NAV_DY[i];
+				if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+				if (!inWall && i >= 4 && (blocked[y * width + nx] || blocked[ny * width + x])) continue;
+				float nd = field.distance[ny * width + nx];
+				if (nd < best) {
+					best = nd;
+					field.direction[cell] = (uint8_t)i;
+				}
+			}
+		}
+	}
+}
+
+/// 流场句柄：多个角色共享；几何变化后 NavigationSystem 在主线程替换 data
+class FlowField {
+	friend class NavigationSystem;
+private:
+	Vector2 goal;
+	std::shared_ptr<const FlowFieldData> data;
+	uint32_t revision; // 每次提交重算加一，丢弃过期的结果
+	bool dirty;        // 需要重算（还没提交）
+	bool failed;       // 目标在网格外或被挡住
+
+public:
+	explicit FlowField(Vector2 target) : goal(target), revision(0), dirty(true), failed(false) {}
+
+	Vector2 GetGoal() const { return goal; }
+	bool IsReady() const { return data != nullptr; }
+	bool IsFailed() const { return failed; }
+
+	/// 所在格子的前进方向（单位向量）；没有结果、在网格外、到达目标或不可达时返回 {0, 0}
+	Vector2 Sample(Vector2 position) const {
+		static const float diagonal = 0.70710678f;
+		static const Vector2 directions[9] = {
+			{1, 0}, {-1, 0}, {0, 1}, {0, -1},
+			{diagonal, diagonal}, {diagonal, -diagonal}, {-diagonal, diagonal}, {-diagonal, -diagonal},
+			{0, 0}
+		};
+		int cell = CellAt(position);
+		return cell < 0 ? directions[FLOW_NONE] : directions[data->direction[cell]];
+	}
+
+	/// 所在格子到目标的路程（像素），不可达或没有结果时返回 FLT_MAX
+	float DistanceAt(Vector2 position) const {
+		int cell = CellAt(position);
+		if (cell < 0 || data->distance[cell] == FLT_MAX) return FLT_MAX;
+		return data->distance[cell] * data->cellSize;
+	}
+
+private:
+	int CellAt(Vector2 position) const {
+		if (!data) return -1;
+		int x = (int)std::floor((position.x - data->area.x) / data->cellSize);
+		int y = (int)std::floor((position.y - data->area.y) / data->cellSize);
+		if (x < 0 || y < 0 || x >= data->width || y >= data->height) return -1;
+		return y * data->width + x;
+	}
+};
+
+typedef std::shared_ptr<FlowField> FlowFieldHandle;
+
+class NavigationSystem {
+private:
+	CollisionSystem& collisions;
+	GameObjectSystem* objects; // 可为空，只用碰撞箱系统
+
+	Rectangle area;
+	float cellSize;
+	float agentRadius;
+	int width;
+	int height;
+	std::vector<uint8_t> blocked;
+
+	std::unordered_map<uint64_t, PathHandle> cache; // 含排队中的请求
+	std::deque<PathHandle> queue;
+	size_t maxCachedPaths;
+
+	// 当前搜索（可跨帧），各数组按格子编号索引，用 searchMark 代替每次清零
+	PathHandle current;
+	std::vector<float> gScore;
+	std::vector<int> parent;
+	std::vector<uint32_t> openMark;
+	std::vector<uint32_t> closedMark;
+	uint32_t searchMark;
+	std::vector<std::pair<float, int>> openHeap;
+
+	GeometryChanges changes;       // 从两个系统取来的变化，复用容量
+	std::vector<Rectangle> blockers; // 重建时收集的阻挡矩形
+	std::vector<int> cellPath;       // 回溯路径用
+
+	// 流场：按目标格缓存；工作线程读网格快照，结果在主线程交给 FlowField
+	struct FlowJob {
+		std::weak_ptr<FlowField> field;
+		uint32_t revision;
+		std::shared_ptr<const std::vector<uint8_t>> grid;
+		std::shared_ptr<FlowFieldData> result;
+	};
+	std::unordered_map<int, FlowFieldHandle> flowFields;
+	std::shared_ptr<const std::vector<uint8_t>> gridSnapshot; // 几何变化后重建
+	std::vector<std::pair<float, int>> flowHeap;              // 同步计算时复用
+	std::mutex flowMutex;
+	std::condition_variable flowWake;
+	std::condition_variable flowDone;
+	std::deque<FlowJob> flowRequests;
+	std::deque<FlowJob> flowResults;
+	std::deque<FlowJob> flowReady; // 主线程取出的结果
+	std::vector<std::thread> flowWorkers;
+	int flowInFlight; // 已提交还没取回的任务
+	bool flowStopping;
+
+	static uint64_t Key(int start, int goal) { return ((uint64_t)(uint32_t)start << 32) | (uint32_t)goal; }
+
+	void SyncGeometry();
+	void BakeCells(int x0, int y0, int x1, int y1);
+	void InvalidateCells(int x0, int y0, int x1, int y1);
+	void InvalidateAll();
+	void BeginSearch();
+	bool StepSearch(int maxExpansions, int& expanded); // 搜索结束时返回 true
+	void FinishSearch(PathStatus status);
+	void EvictPaths();
+	void MarkFlowFieldsDirty();
+	void UpdateFlowFields();
+	void AcceptFlowResults();
+	void FlowWorkerLoop();
+
+	float Heuristic(int cell, int goal) const {
+		float dx = (float)std::abs(cell % width - goal % width);
+		float dy = (float)std::abs(cell / width - goal / width);
+		return dx + dy + (1.41421356f - 2.0f) * std::min(dx, dy);
+	}
+
+public:
+	NavigationSystem(CollisionSystem& collisionSystem, GameObjectSystem* objectSystem = nullptr);
+
+	~NavigationSystem() { StopFlowWorkers(); }
+
+	NavigationSystem(const NavigationSystem&) = delete;
+	NavigationSystem& operator=(const NavigationSystem&) = delete;
+
+	// 按区域和格子大小整体烘焙一次，之前的路径全部作废
+	void Build(const Rectangle& worldArea, float cell, float radius);
+
+	// 每帧在主线程调用：先同步几何变化，再在预算内处理排队的寻路请求
+	void Update(double budgetSeconds = 0.001);
+
+	// 请求从 from 到 to 的路径；相同的起终点格子返回同一个句柄
+	PathHandle RequestPath(Vector2 from, Vector2 to);
+
+	// 手动通知某区域的阻挡变了（例如移动了加入系统后的静态物体）
+	void InvalidateArea(const Rectangle& worldRect);
+
+	int CellAt(Vector2 position) const;
+	Vector2 CellCenter(int cell) const;
+	bool IsBlocked(Vector2 position) const;
+
+	// 绘制 view 范围内不可通行的格子（在相机模式内调用）
+	void DrawDebug(const Rectangle& view) const;
+
+	int GetPendingPathCount() const { return (int)queue.size() + (current ? 1 : 0); }
+	size_t GetCachedPathCount() const { return cache.size(); }
+
+	// 请求走向 goal 的流场；目标在同一格的请求共享一份，几何变化后自动重算
+	FlowFieldHandle RequestFlowField(Vector2 goal);
+
+	// 用 workerCount 个后台线程计算流场（不调用时在 Update 里同步计算）
+	void StartFlowWorkers(int workerCount = 1);
+	void StopFlowWorkers();
+
+	size_t GetFlowFieldCount() const { return flowFields.size(); }
+};
+
+// ==================== NavigationSystem 实现 ====================
+
+NavigationSystem::NavigationSystem(CollisionSystem& collisionSystem, GameObjectSystem* objectSystem)
+: collisions(collisionSystem), objects(objectSystem), area({0, 0, 0, 0}), cellSize(16.0f), agentRadius(0.0f),
+width(0), height(0), maxCachedPaths(4096), searchMark(0), flowInFlight(0), flowStopping(false) {}
+
+void NavigationSystem::Build(const Rectangle& worldArea, float cell, float radius) {
+	area = worldArea;
+	cellSize = cell > 1.0f ? cell : 1.0f;
+	agentRadius = radius > 0.0f ? radius : 0.0f;
+	width = std::max(1, (int)std::ceil(area.width / cellSize));
+	height = std::max(1, (int)std::ceil(area.height / cellSize));
+
+	size_t count = (size_t)width * height;
+	blocked.assign(count, 0);
+	gScore.assign(count, 0.0f);
+	parent.assign(count, -1);
+	openMark.assign(count, 0);
+	closedMark.assign(count, 0);
+	searchMark = 0;
+
+	// 建好之后只关心之后的变化
+	collisions.TakeChanges(changes);
+	if (objects) objects->TakeChanges(changes);
+	BakeCells(0, 0, width - 1, height - 1);
+	InvalidateAll();
+	// 格子编号可能变了，流场按目标位置重新归档
+	std::vector<FlowFieldHandle> fields;
+	for (auto& [cell, field] : flowFields) fields.push_back(field);
+	flowFields.clear();
+	for (auto& field : fields) {
+		int cell = CellAt(field->goal);
+		field->data.reset();
+		field->dirty = true;
+		field->failed = cell < 0;
+		if (cell >= 0) flowFields[cell] = field;
+	}
+	TraceLog(LOG_INFO, "NAV: 网格 %d x %d（格子 %.0f 像素）", width, height, cellSize);
+}
+
+void NavigationSystem::BakeCells(int x0, int y0, int x1, int y1) {
+	x0 = std::max(x0, 0);
+	y0 = std::max(y0, 0);
+	x1 = std::min(x1, width - 1);
+	y1 = std::min(y1, height - 1);
+	if (x0 > x1 || y0 > y1) return;
+
+	for (int y = y0; y <= y1; ++y) {
+		std::fill(blocked.begin() + (size_t)y * width + x0, blocked.begin() + (size_t)y * width + x1 + 1, 0);
+	}
+
+	// 先收集与这块区域相交的阻挡，再逐个把覆盖的格子标记上
+	Rectangle region = {area.x + x0 * cellSize - agentRadius, area.y + y0 * cellSize - agentRadius,
+	                    (x1 - x0 + 1) * cellSize + agentRadius * 2, (y1 - y0 + 1) * cellSize + agentRadius * 2};
+	blockers.clear();
+	auto collect = [this](const Rectangle& rect) { blockers.push_back(rect); };
+	collisions.QuerySolid(region, collect);
+	if (objects) objects->QueryStaticSolids(region, collect);
+
+	for (const Rectangle& rect : blockers) {
+		// 与 CheckCollisionRecs 一致：只接触边缘不算挡住
+		float left = (rect.x - agentRadius - area.x) / cellSize;
+		float top = (rect.y - agentRadius - area.y) / cellSize;
+		float right = (rect.x + rect.width + agentRadius - area.x) / cellSize;
+		float bottom = (rect.y + rect.height + agentRadius - area.y) / cellSize;
+		int cx0 = std::max(x0, (int)std::floor(left));
+		int cy0 = std::max(y0, (int)std::floor(top));
+		int cx1 = std::min(x1, (int)std::ceil(right) - 1);
+		int cy1 = std::min(y1, (int)std::ceil(bottom) - 1);
+		for (int y = cy0; y <= cy1; ++y) {
+			for (int x = cx0; x <= cx1; ++x) {
+				blocked[(size_t)y * width + x] = 1;
+			}
+		}
+	}
+	gridSnapshot.reset();
+	MarkFlowFieldsDirty();
+}
+
+void NavigationSystem::InvalidateCells(int x0, int y0, int x1, int y1) {
+	for (auto it = cache.begin(); it != cache.end();) {
+		NavPath& path = *it->second;
+		// 排队中的请求会在新网格上搜索；失败的路径可能因为阻挡移除而变得可达
+		bool stale = path.status == PathStatus::FAILED ||
+			(path.status == PathStatus::READY &&
+			 path.minX <= x1 && path.maxX >= x0 && path.minY <= y1 && path.maxY >= y0);
+		if (stale) {
+			path.status = PathStatus::STALE;
+			path.points.clear();
+			it = cache.erase(it);
+		} else {
+			++it;
+		}
+	}
+	// 正在进行的搜索已经看过旧的格子，从头再来
+	if (current) {
+		queue.push_front(current);
+		current.reset();
+	}
+}
+
+void NavigationSystem::InvalidateAll() {
+	for (auto& [key, path] : cache) {
+		if (path->status != PathStatus::PENDING) {
+			path->status = PathStatus::STALE;
+			path->points.clear();
+		}
+	}
+	// 网格尺寸可能变了，排队中请求的格子编号也不再可信，一并作废
+	for (auto& path : queue) path->status = PathStatus::STALE;
+	if (current) current->status = PathStatus::STALE;
+	queue.clear();
+	current.reset();
+	cache.clear();
+}
+
+void NavigationSystem::InvalidateArea(const Rectangle& worldRect) {
+	if (blocked.empty()) return;
+	int x0 = (int)std::floor((worldRect.x - agentRadius - area.x) / cellSize);
+	int y0 = (int)std::floor((worldRect.y - agentRadius - area.y) / cellSize);
+	int x1 = (int)std::floor((worldRect.x + worldRect.width + agentRadius - area.x) / cellSize);
+	int y1 = (int)std::floor((worldRect.y + worldRect.height + agentRadius - area.y) / cellSize);
+	if (x1 < 0 || y1 < 0 || x0 >= width || y0 >= height) return;
+	BakeCells(x0, y0, x1, y1);
+	InvalidateCells(x0, y0, x1, y1);
+}
+
+void NavigationSystem::SyncGeometry() {
+	bool reset = false;
+	collisions.TakeChanges(changes);
+	reset |= changes.reset;
+	if (!reset) {
+		for (const Rectangle& rect : changes.areas) InvalidateArea(rect);
+	}
+	if (objects) {
+		objects->TakeChanges(changes);
+		reset |= changes.reset;
+		if (!reset) {
+			for (const Rectangle& rect : changes.areas) InvalidateArea(rect);
+		}
+	}
+	if (reset) {
+		// 系统被整体清空：格子编号不变，重新烘焙后作废全部缓存，排队的请求照常处理
+		BakeCells(0, 0, width - 1, height - 1);
+		InvalidateCells(0, 0, width - 1, height - 1);
+	}
+}
+
+int NavigationSystem::CellAt(Vector2 position) const {
+	int x = (int)std::floor((position.x - area.x) / cellSize);
+	int y = (int)std::floor((position.y - area.y) / cellSize);
+	if (x < 0 || y < 0 || x >= width || y >= height) return -1;
+	return y * width + x;
+}
+
+Vector2 NavigationSystem::CellCenter(int cell) const {
+	return {area.x + (cell % width + 0.5f) * cellSize, area.y + (cell / width + 0.5f) * cellSize};
+}
+
+bool NavigationSystem::IsBlocked(Vector2 position) const {
+	int cell = CellAt(position);
+	return cell < 0 || blocked[cell] != 0;
+}
+
+PathHandle NavigationSystem::RequestPath(Vector2 from, Vector2 to) {
+	int start = CellAt(from);
+	int goal = CellAt(to);
+	if (start < 0 || goal < 0) {
+		auto failed = std::make_shared<NavPath>();
+		failed->status = PathStatus::FAILED;
+		return failed;
+	}
+
+	PathHandle& slot = cache[Key(start, goal)];
+	if (!slot) {
+		AllowFrameAllocations(); // 新的起终点对
+		slot = std::make_shared<NavPath>();
+		slot->startCell = start;
+		slot->goalCell = goal;
+		queue.push_back(slot);
+		if (cache.size() > maxCachedPaths) EvictPaths();
+	}
+	return slot;
+}
+
+void NavigationSystem::EvictPaths() {
+	// 只淘汰已完成且没有人持有的路径
+	for (auto it = cache.begin(); it != cache.end();) {
+		if (it->second->IsDone() && it->second.use_count() == 1) {
+			it = cache.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+void NavigationSystem::BeginSearch() {
+	if (++searchMark == 0) {
+		// 计数回绕，清零一次
+		std::fill(openMark.begin(), openMark.end(), 0);
+		std::fill(closedMark.begin(), closedMark.end(), 0);
+		searchMark = 1;
+	}
+	openHeap.clear();
+
+	int start = current->startCell;
+	gScore[start] = 0.0f;
+	parent[start] = -1;
+	openMark[start] = searchMark;
+	openHeap.push_back({Heuristic(start, current->goalCell), start});
+}
+
+void NavigationSystem::FinishSearch(PathStatus status) {
+	NavPath& path = *current;
+	path.points.clear();
+	path.status = status;
+	if (status == PathStatus::READY) {
+		cellPath.clear();
+		for (int cell = path.goalCell; cell >= 0; cell = parent[cell]) cellPath.push_back(cell);
+		std::reverse(cellPath.begin(), cellPath.end());
+
+		path.minX = path.maxX = path.startCell % width;
+		path.minY = path.maxY = path.startCell / width;
+		for (size_t i = 1; i < cellPath.size(); ++i) {
+			int x = cellPath[i] % width;
+			int y = cellPath[i] / width;
+			path.minX = std::min(path.minX, x);
+			path.maxX = std::max(path.maxX, x);
+			path.minY = std::min(path.minY, y);
+			path.maxY = std::max(path.maxY, y);
+			// 方向不变的中间格子不输出
+			if (i + 1 < cellPath.size() &&
+				cellPath[i] - cellPath[i - 1] == cellPath[i + 1] - cellPath[i]) continue;
+			path.points.push_back(CellCenter(cellPath[i]));
+		}
+		if (path.points.empty()) path.points.push_back(CellCenter(path.goalCell));
+	}
+	current.reset();
+}
+
+bool NavigationSystem::StepSearch(int maxExpansions, int& expanded) {
+	const int goal = current->goalCell;
+	auto cmp = [](const std::pair<float, int>& a, const std::pair<float, int>& b) { return a.first > b.first; };
+
+	while (expanded < maxExpansions) {
+		if (openHeap.empty()) {
+			FinishSearch(PathStatus::FAILED);
+			return true;
+		}
+		std::pop_heap(openHeap.begin(), openHeap.end(), cmp);
+		int cell = openHeap.back().second;
+		openHeap.pop_back();
+		if (closedMark[cell] == searchMark) continue;
+		closedMark[cell] = searchMark;
+		++expanded;
+
+		if (cell == goal) {
+			FinishSearch(PathStatus::READY);
+			return true;
+		}
+
+		int x = cell % width;
+		int y = cell / width;
+		for (int i = 0; i < 8; ++i) {
+			int nx = x + NAV_DX[i];
+			int ny = y + NAV_DY[i];
+			if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+			int next = ny * width + nx;
+			if (blocked[next] || closedMark[next] == searchMark) continue;
+			// 斜走时两侧都要能通过，不切墙角
+			if (i >= 4 && (blocked[y * width + nx] || blocked[ny * width + x])) continue;
+
+			float g = gScore[cell] + NAV_COST[i];
+			if (openMark[next] == searchMark && g >= gScore[next]) continue;
+			openMark[next] = searchMark;
+			gScore[next] = g;
+			parent[next] = cell;
+			openHeap.push_back({g + Heuristic(next, goal), next});
+			std::push_heap(openHeap.begin(), openHeap.end(), cmp);
+		}
+	}
+	return false;
+}
+
+void NavigationSystem::Update(double budgetSeconds) {
+	if (blocked.empty()) return;
+	PROFILE_SCOPE("navigation");
+	SyncGeometry();
+	UpdateFlowFields();
+
+	// 回放时用固定的节点数做预算，与机器快慢无关
+	const bool deterministic = IsInputDeterministic();
+	const int nodeBudget = 8192;
+	const int sliceExpansions = 256; // 每扩展这么多节点检查一次时间
+	double start = GetTime();
+	int expanded = 0;
+
+	while (current || !queue.empty()) {
+		if (!current) {
+			current = queue.front();
+			queue.pop_front();
+			if (current->status != PathStatus::PENDING) { // 已作废
+				current.reset();
+				continue;
+			}
+			if (blocked[current->goalCell]) {
+				FinishSearch(PathStatus::FAILED);
+				continue;
+			}
+			BeginSearch();
+		}
+
+		int limit = deterministic ? nodeBudget : expanded + sliceExpansions;
+		StepSearch(limit, expanded);
+
+		if (deterministic ? expanded >= nodeBudget : GetTime() - start >= budgetSeconds) break;
+	}
+}
+
+void NavigationSystem::DrawDebug(const Rectangle& view) const {
+	if (blocked.empty()) return;
+	int x0 = std::max(0, (int)std::floor((view.x - area.x) / cellSize));
+	int y0 = std::max(0, (int)std::floor((view.y - area.y) / cellSize));
+	int x1 = std::min(width - 1, (int)std::floor((view.x + view.width - area.x) / cellSize));
+	int y1 = std::min(height - 1, (int)std::floor((view.y + view.height - area.y) / cellSize));
+	for (int y = y0; y <= y1; ++y) {
+		for (int x = x0; x <= x1; ++x) {
+			if (blocked[(size_t)y * width + x]) {
+				DrawRectangleRec({area.x + x * cellSize, area.y + y * cellSize, cellSize, cellSize}, Fade(RED, 0.25f));
+			}
+		}
+	}
+}
+
+// ==================== 流场实现 ====================
+
+FlowFieldHandle NavigationSystem::RequestFlowField(Vector2 goal) {
+	int cell = CellAt(goal);
+	if (cell < 0) {
+		auto failed = std::make_shared<FlowField>(goal);
+		failed->dirty = false;
+		failed->failed = true;
+		return failed;
+	}
+	FlowFieldHandle& slot = flowFields[cell];
+	if (!slot) {
+		AllowFrameAllocations(); // 新目标
+		slot = std::make_shared<FlowField>(CellCenter(cell));
+	}
+	return slot;
+}
+
+void NavigationSystem::MarkFlowFieldsDirty() {
+	for (auto& [cell, field] : flowFields) field->dirty = true;
+}
+
+void NavigationSystem::UpdateFlowFields() {
+	AcceptFlowResults();
+
+	bool computedInline = false;
+	for (auto it = flowFields.begin(); it != flowFields.end();) {
+		FlowField& field = *it->second;
+		// 没有角色持有的流场不再维护
+		if (it->second.use_count() == 1) {
+			it = flowFields.erase(it);
+			continue;
+		}
+		if (!field.dirty || (flowWorkers.empty() && computedInline)) {
+			++it;
+			continue;
+		}
+
+		AllowFrameAllocations(); // 重算流场要分配结果
+		if (!gridSnapshot) gridSnapshot = std::make_shared<const std::vector<uint8_t>>(blocked);
+		FlowJob job;
+		job.field = it->second;
+		job.revision = ++field.revision;
+		job.grid = gridSnapshot;
+		job.result = std::make_shared<FlowFieldData>();
+		job.result->area = area;
+		job.result->cellSize = cellSize;
+		job.result->width = width;
+		job.result->height = height;
+		job.result->goalCell = it->first;
+		field.dirty = false;
+		field.failed = blocked[it->first] != 0;
+
+		if (flowWorkers.empty()) {
+			PROFILE_SCOPE("flow field");
+			BuildFlowFieldData(*job.result, *job.grid, flowHeap);
+			field.data = job.result;
+			computedInline = true;
+		} else {
+			{
+				std::lock_guard<std::mutex> lock(flowMutex);
+				flowRequests.push_back(std::move(job));
+			}
+			++flowInFlight;
+			flowWake.notify_one();
+		}
+		++it;
+	}
+
+	// 回放时等后台算完，流场生效的 tick 可以复现
+	if (IsInputDeterministic() && flowInFlight > 0) {
+		std::unique_lock<std::mutex> lock(flowMutex);
+		flowDone.wait(lock, [this] { return (int)flowResults.size() >= flowInFlight; });
+		lock.unlock();
+		AcceptFlowResults();
+	}
+}
+
+void NavigationSystem::AcceptFlowResults() {
+	if (flowInFlight == 0) return;
+	{
+		std::lock_guard<std::mutex> lock(flowMutex);
+		flowReady.swap(flowResults);
+	}
+	for (auto& job : flowReady) {
+		--flowInFlight;
+		FlowFieldHandle field = job.field.lock();
+		// 提交之后又重算过的，只用最新一次的结果
+		if (field && field->revision == job.revision) field->data = std::move(job.result);
+	}
+	flowReady.clear();
+}
+
+void NavigationSystem::FlowWorkerLoop() {
+	SetProfileThreadName("flow field");
+	std::vector<std::pair<float, int>> heap;
+	while (true) {
+		FlowJob job;
+		{
+			std::unique_lock<std::mutex> lock(flowMutex);
+			flowWake.wait(lock, [this] { return flowStopping || !flowRequests.empty(); });
+			if (flowStopping) return;
+			job = std::move(flowRequests.front());
+			flowRequests.pop_front();
+		}
+
+		{
+			PROFILE_SCOPE("flow field");
+			BuildFlowFieldData(*job.result, *job.grid, heap);
+		}
+		job.grid.reset();
+
+		{
+			std::lock_guard<std::mutex> lock(flowMutex);
+			flowResults.push_back(std::move(job));
+		}
+		flowDone.notify_all();
+	}
+}
+
+void NavigationSystem::StartFlowWorkers(int workerCount) {
+	if (!flowWorkers.empty()) return;
+	flowStopping = false;
+	if (workerCount < 1) workerCount = 1;
+	for (int i = 0; i < workerCount; ++i) {
+		flowWorkers.emplace_back(&NavigationSystem::FlowWorkerLoop, this);
+	}
+}
+
+void NavigationSystem::StopFlowWorkers() {
+	{
+		std::lock_guard<std::mutex> lock(flowMutex);
+		flowStopping = true;
+	}
+	flowWake.notify_all();
+	for (auto& worker : flowWorkers) {
+		worker.join();
+	}
+	flowWorkers.clear();
+
+	// 已算完的照常交付，没开始算的留到下次 Update 同步计算
+	for (auto& job : flowRequests) {
+		FlowFieldHandle field = job.field.lock();
+		if (field && field->revision == job.revision) field->dirty = true;
+	}
+	flowInFlight -= (int)flowRequests.size();
+	flowRequests.clear();
+	AcceptFlowResults();
+	flowInFlight = 0;
+}
+
+#endif // NAVIGATION_H
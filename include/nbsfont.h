@@ -0,0 +1,98 @@
+#ifndef NBSFONT_H
+#define NBSFONT_H
+
+#include "raylib.h"
+#include "assetpack.h"
+#include <string>
+#include <set>
+#include <cstdio>
+#include <cstring>
+using namespace std;
+
+/// 用于缓存已加载字体的结构体
+struct CachedFont {
+	string key; // 唯一标识（例如文本＋字号）
+	Font fnt; // 字体对象
+
+	bool operator<(const CachedFont &other) const {
+		return key < other.key;
+	}
+	// 直接用字符串查找，不必构造临时的 CachedFont
+	friend bool operator<(const CachedFont &a, const string &b) { return a.key < b; }
+	friend bool operator<(const string &a, const CachedFont &b) { return a < b.key; }
+};
+
+// 字体缓存和字体数据
+static set<CachedFont, less<>> fntCache;
+static string fntKey;  // 查找用的键，复用容量避免每次分配
+static string fntText; // DrawTextUTF 补空格后的文本，同上
+static int fntFileSize = 0;
+static unsigned char *fntFileData = nullptr;
+static PackData fntPackData = {nullptr, 0, nullptr}; // 字体来自资源包时不复制
+
+/// 初始化字体系统（程序启动时调用）
+bool InitFontSystem(const char *fontPath) {
+	fntPackData = assetPack.Load(fontPath);
+	if (fntPackData.data) {
+		fntFileData = (unsigned char *)fntPackData.data;
+		fntFileSize = fntPackData.size;
+		return fntFileSize > 0;
+	}
+	fntFileData = LoadFileData(fontPath, &fntFileSize);
+	return (fntFileData != nullptr && fntFileSize > 0);
+}
+
+/// 卸载字体系统（程序结束时调用）
+void UnloadFontSystem() {
+	for (const auto& item : fntCache) {
+		UnloadFont(item.fnt);
+	}
+	fntCache.clear();
+
+	if (fntPackData.data) {
+		UnloadPackData(fntPackData);
+	} else if (fntFileData) {
+		UnloadFileData(fntFileData);
+	}
+	fntFileData = nullptr;
+	fntFileSize = 0;
+}
+
+/// 动态加载字体的函数
+Font GetDynamicFont(const char *txt, int fntSize = 32) {
+	char suffix[16];
+	snprintf(suffix, sizeof(suffix), "_%d", fntSize);
+	fntKey.assign(txt).append(suffix);
+	auto it = fntCache.find(fntKey);
+	if (it != fntCache.end()) {
+		return it->fnt;
+	}
+
+	int cpCount = 0;
+	int *cps = LoadCodepoints(txt, &cpCount);
+	Font fnt = LoadFontFromMemory(".ttf", fntFileData, fntFileSize, fntSize, cps, cpCount);
+	UnloadCodepoints(cps);
+
+	fntCache.insert({fntKey, fnt});
+	return fnt;
+}
+
+/// 绘制 UTF-8 文本的前 len 字节
+void DrawTextUTF(const char *txt, size_t len, Vector2 pos, int fntSize, float spacing, Color color) {
+	if (fntSize == 0 or len == 0) return;
+	fntText.assign(txt, len);
+	fntText.append(len % 2 ? 8 : 7, ' ');
+	Font fnt = GetDynamicFont(fntText.c_str(), fntSize);
+	DrawTextEx(fnt, fntText.c_str(), pos, (float)fntSize, spacing, color);
+}
+
+/// 绘制 UTF-8 文本
+void DrawTextUTF(const string &stxt, Vector2 pos, int fntSize, float spacing, Color color) {
+	DrawTextUTF(stxt.data(), stxt.size(), pos, fntSize, spacing, color);
+}
+
+void DrawTextUTF(const char *txt, Vector2 pos, int fntSize, float spacing, Color color) {
+	DrawTextUTF(txt, strlen(txt), pos, fntSize, spacing, color);
+}
+
+#endif // NBSFONT_H
@@ -0,0 +1,275 @@
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include "raylib.h"
+#include "rlgl.h"
+#include "input.h"
+#include "profiler.h"
+#include <vector>
+#include <cstdint>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PARTICLES_SSE 1
+#else
+#define PARTICLES_SSE 0
+#endif
+
+// ==================== 粒子系统 ====================
+//
+// 粒子按 (贴图, 图层) 分池，每个池容量固定，属性按字段分别存放在连续的 float 数组里
+// （结构数组转数组结构），积分一次处理 4 个粒子（SSE2），死亡的粒子与末尾交换后移除。
+// 绘制时每个池设置一次贴图，全部粒子以四边形写入 rlgl 的批次，一个池一次提交。
+//
+// 玩法代码在事件发生时调用 EmitParticles(效果, 位置) 发射一批粒子；每帧 UpdateParticles
+// 推进（按游戏时钟，回放时与录制一致），DrawParticles(图层) 在对应的坐标系里绘制：
+// PARTICLE_WORLD 在相机模式内，PARTICLE_SCREEN 在 UI 阶段。
+
+enum ParticleLayer {
+	PARTICLE_WORLD,  // 世界坐标，随相机移动
+	PARTICLE_SCREEN, // 屏幕坐标，画在 UI 上
+	PARTICLE_LAYER_COUNT
+};
+
+/// 一次发射的参数
+struct ParticleEffect {
+	Texture2D texture = {0};              // id 为 0 时画纯色方块
+	ParticleLayer layer = PARTICLE_WORLD;
+	int count = 32;
+	float angle = 0.0f;                   // 发射方向（弧度）
+	float spread = 2.0f * PI;             // 方向的张角，2π 为全方向
+	float speedMin = 40.0f;
+	float speedMax = 160.0f;
+	float lifeMin = 0.4f;                 // 寿命（秒）
+	float lifeMax = 0.8f;
+	float sizeStart = 6.0f;               // 边长，随寿命线性变化到 sizeEnd
+	float sizeEnd = 0.0f;
+	Color colorStart = WHITE;             // 颜色随寿命线性变化
+	Color colorEnd = {255, 255, 255, 0};
+	Vector2 gravity = {0.0f, 0.0f};       // 加速度（像素/秒²）
+	float drag = 0.0f;                    // 每秒损失的速度比例
+	float radius = 0.0f;                  // 在此半径的圆内随机出生
+};
+
+struct ParticlePool {
+	Texture2D texture;
+	ParticleLayer layer;
+	int capacity;
+	int count;
+	// 每个数组长度为 capacity 向上取 4 的倍数，积分时可以整组处理末尾
+	std::vector<float> x, y, vx, vy, ax, ay, drag, age, life, size0, size1;
+	std::vector<uint32_t> color0, color1; // RGBA 打包
+
+	void Allocate(int maxParticles) {
+		capacity = maxParticles;
+		count = 0;
+		size_t padded = (size_t)((maxParticles + 3) & ~3);
+		for (std::vector<float>* field : {&x, &y, &vx, &vy, &ax, &ay, &drag, &age, &life, &size0, &size1}) {
+			field->assign(padded, 0.0f);
+		}
+		color0.assign(padded, 0);
+		color1.assign(padded, 0);
+		// 填充位的 life 设为正数，避免整组积分时出现 0/0
+		for (size_t i = 0; i < padded; ++i) life[i] = 1.0f;
+	}
+
+	void Move(int from, int to) {
+		x[to] = x[from];
+		y[to] = y[from];
+		vx[to] = vx[from];
+		vy[to] = vy[from];
+		ax[to] = ax[from];
+		ay[to] = ay[from];
+		drag[to] = drag[from];
+		age[to] = age[from];
+		life[to] = life[from];
+		size0[to] = size0[from];
+		size1[to] = size1[from];
+		color0[to] = color0[from];
+		color1[to] = color1[from];
+	}
+};
+
+static std::vector<ParticlePool> particlePools;
+static int particlePoolCapacity = 32768;
+static uint32_t particleRandomState = 0x9E3779B9u; // 固定种子，回放时粒子也一致
+
+static float ParticleRandom() {
+	// xorshift32，取高 24 位映射到 [0, 1)
+	particleRandomState ^= particleRandomState << 13;
+	particleRandomState ^= particleRandomState >> 17;
+	particleRandomState ^= particleRandomState << 5;
+	return (particleRandomState >> 8) * (1.0f / 16777216.0f);
+}
+
+static uint32_t PackParticleColor(Color color) {
+	return (uint32_t)color.r | ((uint32_t)color.g << 8) | ((uint32_t)color.b << 16) | ((uint32_t)color.a << 24);
+}
+
+/// 之后新建的池的容量（已经建好的池不变）
+void SetParticleCapacity(int maxParticlesPerPool) {
+	particlePoolCapacity = maxParticlesPerPool > 0 ? maxParticlesPerPool : 1;
+}
+
+ParticlePool& GetParticlePool(const Texture2D& texture, ParticleLayer layer) {
+	for (auto& pool : particlePools) {
+		if (pool.texture.id == texture.id && pool.layer == layer) return pool;
+	}
+	AllowFrameAllocations(); // 第一次用到这张贴图
+	particlePools.emplace_back();
+	ParticlePool& pool = particlePools.back();
+	pool.texture = texture;
+	pool.layer = layer;
+	pool.Allocate(particlePoolCapacity);
+	return pool;
+}
+
+/// 在 position 发射一批粒子，返回实际发射的数量（池满时少发）
+int EmitParticles(const ParticleEffect& effect, Vector2 position, int count = -1) {
+	ParticlePool& pool = GetParticlePool(effect.texture, effect.layer);
+	if (count < 0) count = effect.count;
+	if (count > pool.capacity - pool.count) count = pool.capacity - pool.count;
+
+	uint32_t color0 = PackParticleColor(effect.colorStart);
+	uint32_t color1 = PackParticleColor(effect.colorEnd);
+	for (int n = 0; n < count; ++n) {
+		int i = pool.count++;
+		float angle = effect.angle + (ParticleRandom() - 0.5f) * effect.spread;
+		float speed = effect.speedMin + (effect.speedMax - effect.speedMin) * ParticleRandom();
+		float offsetAngle = ParticleRandom() * 2.0f * PI;
+		float offset = effect.radius * std::sqrt(ParticleRandom());
+		pool.x[i] = position.x + std::cos(offsetAngle) * offset;
+		pool.y[i] = position.y + std::sin(offsetAngle) * offset;
+		pool.vx[i] = std::cos(angle) * speed;
+		pool.vy[i] = std::sin(angle) * speed;
+		pool.ax[i] = effect.gravity.x;
+		pool.ay[i] = effect.gravity.y;
+		pool.drag[i] = effect.drag;
+		pool.age[i] = 0.0f;
+		pool.life[i] = effect.lifeMin + (effect.lifeMax - effect.lifeMin) * ParticleRandom();
+		if (pool.life[i] <= 0.0f) pool.life[i] = 0.001f;
+		pool.size0[i] = effect.sizeStart;
+		pool.size1[i] = effect.sizeEnd;
+		pool.color0[i] = color0;
+		pool.color1[i] = color1;
+	}
+	return count;
+}
+
+/// 积分一个池：v = v·max(0, 1 - drag·dt) + a·dt，p += v·dt，age += dt
+static void IntegrateParticles(ParticlePool& pool, float dt) {
+	const int n = (pool.count + 3) & ~3;
+	float* x = pool.x.data();
+	float* y = pool.y.data();
+	float* vx = pool.vx.data();
+	float* vy = pool.vy.data();
+	const float* ax = pool.ax.data();
+	const float* ay = pool.ay.data();
+	const float* drag = pool.drag.data();
+	float* age = pool.age.data();
+
+#if PARTICLES_SSE
+	const __m128 step = _mm_set1_ps(dt);
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 zero = _mm_setzero_ps();
+	for (int i = 0; i < n; i += 4) {
+		__m128 keep = _mm_max_ps(zero, _mm_sub_ps(one, _mm_mul_ps(_mm_loadu_ps(drag + i), step)));
+		__m128 newVx = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(vx + i), keep), _mm_mul_ps(_mm_loadu_ps(ax + i), step));
+		__m128 newVy = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(vy + i), keep), _mm_mul_ps(_mm_loadu_ps(ay + i), step));
+		_mm_storeu_ps(vx + i, newVx);
+		_mm_storeu_ps(vy + i, newVy);
+		_mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(newVx, step)));
+		_mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(newVy, step)));
+		_mm_storeu_ps(age + i, _mm_add_ps(_mm_loadu_ps(age + i), step));
+	}
+#else
+	for (int i = 0; i < n; ++i) {
+		float keep = std::fmax(0.0f, 1.0f - drag[i] * dt);
+		vx[i] = vx[i] * keep + ax[i] * dt;
+		vy[i] = vy[i] * keep + ay[i] * dt;
+		x[i] += vx[i] * dt;
+		y[i] += vy[i] * dt;
+		age[i] += dt;
+	}
+#endif
+
+	// 移除到期的粒子（与末尾交换，顺序无关）
+	int i = 0;
+	while (i < pool.count) {
+		if (pool.age[i] >= pool.life[i]) {
+			pool.Move(--pool.count, i);
+		} else {
+			++i;
+		}
+	}
+}
+
+/// 每帧调用一次，按游戏时钟推进所有粒子
+void UpdateParticles() {
+	PROFILE_SCOPE("particles update");
+	float dt = GetInputDeltaTime();
+	for (auto& pool : particlePools) {
+		if (pool.count > 0) IntegrateParticles(pool, dt);
+	}
+}
+
+static unsigned char LerpParticleChannel(uint32_t a, uint32_t b, int shift, float t) {
+	float from = (float)((a >> shift) & 0xFF);
+	float to = (float)((b >> shift) & 0xFF);
+	return (unsigned char)(from + (to - from) * t);
+}
+
+/// 绘制一个图层的全部粒子，每个池一次批量提交
+void DrawParticles(ParticleLayer layer) {
+	PROFILE_SCOPE("particles draw");
+	const int chunk = 1024; // 每写这么多个四边形检查一次批次余量
+	for (const auto& pool : particlePools) {
+		if (pool.layer != layer || pool.count == 0) continue;
+
+		rlSetTexture(pool.texture.id != 0 ? pool.texture.id : rlGetTextureIdDefault());
+		rlBegin(RL_QUADS);
+		rlNormal3f(0.0f, 0.0f, 1.0f);
+		for (int i = 0; i < pool.count; ++i) {
+			if (i % chunk == 0) {
+				int quads = pool.count - i < chunk ? pool.count - i : chunk;
+				rlCheckRenderBatchLimit(quads * 4);
+			}
+			float t = pool.age[i] / pool.life[i];
+			float half = (pool.size0[i] + (pool.size1[i] - pool.size0[i]) * t) * 0.5f;
+			float left = pool.x[i] - half;
+			float top = pool.y[i] - half;
+			float right = pool.x[i] + half;
+			float bottom = pool.y[i] + half;
+			uint32_t c0 = pool.color0[i];
+			uint32_t c1 = pool.color1[i];
+			rlColor4ub(LerpParticleChannel(c0, c1, 0, t), LerpParticleChannel(c0, c1, 8, t),
+			           LerpParticleChannel(c0, c1, 16, t), LerpParticleChannel(c0, c1, 24, t));
+
+			rlTexCoord2f(0.0f, 0.0f);
+			rlVertex2f(left, top);
+			rlTexCoord2f(0.0f, 1.0f);
+			rlVertex2f(left, bottom);
+			rlTexCoord2f(1.0f, 1.0f);
+			rlVertex2f(right, bottom);
+			rlTexCoord2f(1.0f, 0.0f);
+			rlVertex2f(right, top);
+		}
+		rlEnd();
+		rlSetTexture(0);
+	}
+}
+
+/// 当前存活的粒子总数
+int GetParticleCount() {
+	int total = 0;
+	for (const auto& pool : particlePools) total += pool.count;
+	return total;
+}
+
+/// 清除所有粒子（保留池的内存）
+void ClearParticles() {
+	for (auto& pool : particlePools) pool.count = 0;
+}
+
+#endif // PARTICLES_H
@@ -0,0 +1,367 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "raylib.h"
+#include "framemem.h"
+#include <string>
+
+// ==================== 帧性能分析 ====================
+//
+// 在代码里插入计时标记：
+//   PROFILE_SCOPE("collision");          到作用域结束为止
+//   PROFILE_BEGIN("update"); ... PROFILE_END();   顺序代码中的一段，可以嵌套
+//   PROFILE_FRAME();                     每帧开头调用一次，统计上一帧
+//
+// 每个线程把结束的标记写入自己的环形缓冲，写入不加锁；主线程每帧汇总自己的标记，
+// 在叠加层显示各段耗时、分配次数和最近 120 帧的直方图。ExportProfilerTrace 把所有线程
+// 缓冲中的标记导出为 Chrome trace JSON（chrome://tracing 或 Perfetto 打开）。
+//
+// 标记名必须是字符串常量（只保存指针）。
+// 定义 NDEBUG 的发布版本中所有标记展开为空；需要在发布版中分析时定义 NB_PROFILE。
+
+#if !defined(NDEBUG) || defined(NB_PROFILE)
+#define PROFILER_ENABLED 1
+#else
+#define PROFILER_ENABLED 0
+#endif
+
+#if PROFILER_ENABLED
+
+#include "savefile.h"
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+
+struct ProfileEvent {
+	const char* name;
+	int64_t start; // 纳秒
+	int64_t end;
+	int depth;
+	uint32_t allocs; // 段内（含子段）的分配次数和字节数
+	uint32_t bytes;
+};
+
+static const uint64_t PROFILE_RING_SIZE = 1u << 14; // 每个线程保留的标记数（2 的幂）
+static const int PROFILE_HISTORY = 120;             // 叠加层统计的帧数
+
+/// PROFILE_BEGIN 尚未结束的段
+struct ProfileOpenSpan {
+	ProfileEvent event; // end 和分配量在 PROFILE_END 时填写
+	AllocCounters base;
+};
+
+/// 每个线程一份，只有所属线程写入
+struct ProfileThreadBuffer {
+	int index;
+	std::string name;
+	ProfileEvent events[PROFILE_RING_SIZE];
+	std::atomic<uint64_t> head{0}; // 已写入的标记总数
+	int depth = 0;
+	std::vector<ProfileOpenSpan> open;
+};
+
+/// 叠加层中一个标记名的统计
+struct ProfileScopeStats {
+	const char* name;
+	int depth;
+	int64_t offset;                 // 最近一次在帧内开始的时刻，按它排序得到调用顺序
+	float frameMs;                  // 当前帧累计
+	uint32_t frameAllocs;
+	float history[PROFILE_HISTORY]; // 每帧耗时（毫秒）
+	uint32_t allocHistory[PROFILE_HISTORY];
+};
+
+static std::mutex profileThreadsMutex;
+static std::vector<std::unique_ptr<ProfileThreadBuffer>> profileThreads; // 线程退出后缓冲仍保留，供导出
+static thread_local ProfileThreadBuffer* profileLocal = nullptr;
+
+static std::vector<ProfileScopeStats> profileScopes; // 按帧内开始时刻排序，父段在子段之前
+static std::unordered_map<const char*, size_t> profileScopeIndex;
+static float profileFrameHistory[PROFILE_HISTORY];
+static uint32_t profileFrameAllocHistory[PROFILE_HISTORY];
+static AllocCounters profileFrameAllocBase = {0, 0}; // 上一帧结束时主线程的分配计数
+static uint64_t profileFrameCount = 0;
+static int profileHistoryPos = 0;
+static int64_t profileFrameStart = 0;
+static uint64_t profileConsumed = 0; // 主线程已汇总到的位置
+static bool profileOverlayVisible = false;
+
+inline int64_t ProfileNow() {
+	static const auto epoch = std::chrono::steady_clock::now();
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+static ProfileThreadBuffer* GetProfileBuffer() {
+	if (!profileLocal) {
+		auto buffer = std::make_unique<ProfileThreadBuffer>();
+		std::lock_guard<std::mutex> lock(profileThreadsMutex);
+		buffer->index = (int)profileThreads.size();
+		buffer->name = "thread " + std::to_string(buffer->index);
+		profileLocal = buffer.get();
+		profileThreads.push_back(std::move(buffer));
+	}
+	return profileLocal;
+}
+
+/// 给当前线程起名（显示在导出的 trace 中）
+void SetProfileThreadName(const char* name) {
+	ProfileThreadBuffer* buffer = GetProfileBuffer();
+	std::lock_guard<std::mutex> lock(profileThreadsMutex);
+	buffer->name = name;
+}
+
+inline void PushProfileEvent(ProfileThreadBuffer* buffer, ProfileEvent event, const AllocCounters& base) {
+	event.end = ProfileNow();
+	event.allocs = (uint32_t)(allocCounters.count - base.count);
+	event.bytes = (uint32_t)(allocCounters.bytes - base.bytes);
+	uint64_t head = buffer->head.load(std::memory_order_relaxed);
+	buffer->events[head & (PROFILE_RING_SIZE - 1)] = event;
+	buffer->head.store(head + 1, std::memory_order_release);
+}
+
+class ProfileScope {
+private:
+	ProfileThreadBuffer* buffer;
+	ProfileEvent event;
+	AllocCounters base;
+	const char* parentScope;
+
+public:
+	explicit ProfileScope(const char* scopeName) : buffer(GetProfileBuffer()) {
+		event = {scopeName, 0, 0, buffer->depth++, 0, 0};
+		parentScope = allocScope;
+		allocScope = scopeName;
+		base = allocCounters;
+		event.start = ProfileNow();
+	}
+	~ProfileScope() {
+		--buffer->depth;
+		allocScope = parentScope;
+		PushProfileEvent(buffer, event, base);
+	}
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+void ProfileBegin(const char* name) {
+	ProfileThreadBuffer* buffer = GetProfileBuffer();
+	if (buffer->open.capacity() == 0) buffer->open.reserve(32);
+	buffer->open.push_back({{name, 0, 0, buffer->depth++, 0, 0}, allocCounters});
+	allocScope = name;
+	buffer->open.back().event.start = ProfileNow();
+}
+
+void ProfileEnd() {
+	ProfileThreadBuffer* buffer = GetProfileBuffer();
+	if (buffer->open.empty()) return;
+	ProfileOpenSpan span = buffer->open.back();
+	buffer->open.pop_back();
+	--buffer->depth;
+	allocScope = buffer->open.empty() ? nullptr : buffer->open.back().event.name;
+	PushProfileEvent(buffer, span.event, span.base);
+}
+
+/// 稳态检查：报告本帧有分配的分析段（只报告最内层，外层段的分配包含子段）
+static void ReportFrameAllocations(uint64_t frameAllocs, uint64_t frameBytes) {
+	// profileScopes 按调用顺序排列，紧跟其后且更深的段就是它的子段
+	std::string scopes;
+	for (size_t i = 0; i < profileScopes.size(); ++i) {
+		const ProfileScopeStats& scope = profileScopes[i];
+		if (scope.frameAllocs == 0) continue;
+		bool childAllocated = false;
+		for (size_t j = i + 1; j < profileScopes.size() && profileScopes[j].depth > scope.depth; ++j) {
+			if (profileScopes[j].frameAllocs > 0) {
+				childAllocated = true;
+				break;
+			}
+		}
+		if (childAllocated) continue;
+		scopes += std::string(scopes.empty() ? "" : ", ") + scope.name + " x" + std::to_string(scope.frameAllocs);
+	}
+	TraceLog(LOG_WARNING, "ALLOC: 第 %llu 帧分配了 %llu 次，%llu 字节 [%s]", (unsigned long long)profileFrameCount,
+	         (unsigned long long)frameAllocs, (unsigned long long)frameBytes, scopes.empty() ? "不在分析段内" : scopes.c_str());
+}
+
+/// 每帧开头在主线程调用：汇总上一帧主线程的标记和分配
+void ProfilerFrame() {
+	ProfileThreadBuffer* buffer = GetProfileBuffer();
+	int64_t now = ProfileNow();
+	if (profileFrameStart == 0) {
+		{
+			std::lock_guard<std::mutex> lock(profileThreadsMutex);
+			buffer->name = "main";
+		}
+		profileFrameStart = now;
+		profileConsumed = buffer->head.load(std::memory_order_relaxed);
+		profileFrameAllocBase = allocCounters;
+		return;
+	}
+	uint64_t frameAllocs = allocCounters.count - profileFrameAllocBase.count;
+	uint64_t frameBytes = allocCounters.bytes - profileFrameAllocBase.bytes;
+	bool guarded = allocGuardArmed;
+	++profileFrameCount;
+
+	uint64_t head = buffer->head.load(std::memory_order_relaxed);
+	if (head - profileConsumed > PROFILE_RING_SIZE) profileConsumed = head - PROFILE_RING_SIZE;
+	for (uint64_t i = profileConsumed; i < head; ++i) {
+		const ProfileEvent& event = buffer->events[i & (PROFILE_RING_SIZE - 1)];
+		auto it = profileScopeIndex.find(event.name);
+		if (it == profileScopeIndex.end()) {
+			ProfileScopeStats stats = {event.name, event.depth, 0, 0.0f, 0, {}, {}};
+			it = profileScopeIndex.emplace(event.name, profileScopes.size()).first;
+			profileScopes.push_back(stats);
+		}
+		ProfileScopeStats& scope = profileScopes[it->second];
+		if (scope.frameMs == 0.0f) scope.offset = event.start - profileFrameStart;
+		scope.frameMs += (event.end - event.start) / 1e6f;
+		scope.frameAllocs += event.allocs;
+	}
+	if (head != profileConsumed) {
+		std::stable_sort(profileScopes.begin(), profileScopes.end(),
+		[](const ProfileScopeStats& a, const ProfileScopeStats& b) {
+			return a.offset < b.offset;
+		});
+		for (size_t i = 0; i < profileScopes.size(); ++i) {
+			profileScopeIndex[profileScopes[i].name] = i;
+		}
+	}
+	profileConsumed = head;
+
+	if (guarded && frameAllocs > 0 && allocGuardMode == ALLOC_GUARD_WARN) {
+		ReportFrameAllocations(frameAllocs, frameBytes);
+	}
+
+	for (auto& scope : profileScopes) {
+		scope.history[profileHistoryPos] = scope.frameMs;
+		scope.allocHistory[profileHistoryPos] = scope.frameAllocs;
+		scope.frameMs = 0.0f;
+		scope.frameAllocs = 0;
+	}
+	profileFrameHistory[profileHistoryPos] = (now - profileFrameStart) / 1e6f;
+	profileFrameAllocHistory[profileHistoryPos] = (uint32_t)frameAllocs;
+	profileHistoryPos = (profileHistoryPos + 1) % PROFILE_HISTORY;
+	profileFrameStart = now;
+
+	// 汇总本身的分配不计入下一帧
+	allocGuardArmed = allocGuardMode != ALLOC_GUARD_OFF && profileFrameCount >= (uint64_t)allocGuardWarmup;
+	profileFrameAllocBase = allocCounters;
+}
+
+void ToggleProfilerOverlay() {
+	profileOverlayVisible = !profileOverlayVisible;
+}
+
+bool IsProfilerOverlayVisible() {
+	return profileOverlayVisible;
+}
+
+/// 绘制一行统计：名称、平均/最大毫秒、每帧平均分配次数和最近帧的直方图（满格为 1/60 秒）
+static void DrawProfileRow(int x, int y, const char* name, int depth, const float* history, const uint32_t* allocs) {
+	float total = 0.0f;
+	float worst = 0.0f;
+	uint64_t allocTotal = 0;
+	for (int i = 0; i < PROFILE_HISTORY; ++i) {
+		total += history[i];
+		allocTotal += allocs[i];
+		if (history[i] > worst) worst = history[i];
+	}
+	DrawText(name, x + depth * 10, y, 10, RAYWHITE);
+	DrawText(TextFormat("%6.2f %6.2f %6.1f", total / PROFILE_HISTORY, worst, (float)allocTotal / PROFILE_HISTORY),
+	         x + 130, y, 10, allocTotal > 0 ? ORANGE : RAYWHITE);
+
+	int graphX = x + 250;
+	DrawRectangle(graphX, y, PROFILE_HISTORY, 10, Fade(BLACK, 0.5f));
+	for (int i = 0; i < PROFILE_HISTORY; ++i) {
+		float value = history[(profileHistoryPos + i) % PROFILE_HISTORY];
+		int height = (int)(value / (1000.0f / 60.0f) * 10.0f);
+		if (height <= 0) continue;
+		if (height > 10) height = 10;
+		Color color = value > 1000.0f / 60.0f ? RED : (value > 1000.0f / 120.0f ? ORANGE : GREEN);
+		DrawRectangle(graphX + i, y + 10 - height, 1, height, color);
+	}
+}
+
+/// 绘制叠加层（在 BeginDrawing/EndDrawing 之间、相机模式之外调用）
+void DrawProfilerOverlay(int x = 10, int y = 140) {
+	if (!profileOverlayVisible) return;
+
+	int rows = (int)profileScopes.size() + 2;
+	DrawRectangle(x - 5, y - 5, 385, rows * 14 + 8, Fade(BLACK, 0.7f));
+	DrawText("scope                 avg ms  max ms  alloc", x, y, 10, YELLOW);
+	y += 14;
+	DrawProfileRow(x, y, "frame", 0, profileFrameHistory, profileFrameAllocHistory);
+	for (const auto& scope : profileScopes) {
+		y += 14;
+		DrawProfileRow(x, y, scope.name, scope.depth, scope.history, scope.allocHistory);
+	}
+}
+
+/// 把各线程缓冲中的标记导出为 Chrome trace JSON
+bool ExportProfilerTrace(const std::string& path) {
+	std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	bool first = true;
+	std::vector<ProfileEvent> copy;
+
+	std::lock_guard<std::mutex> lock(profileThreadsMutex);
+	for (const auto& buffer : profileThreads) {
+		json += std::string(first ? "" : ",\n") + "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" +
+		        std::to_string(buffer->index) + ",\"args\":{\"name\":\"" + buffer->name + "\"}}";
+		first = false;
+
+		// 复制后再读一次 head，丢弃复制期间可能被覆盖的旧标记
+		uint64_t head = buffer->head.load(std::memory_order_acquire);
+		uint64_t begin = head > PROFILE_RING_SIZE ? head - PROFILE_RING_SIZE : 0;
+		copy.clear();
+		for (uint64_t i = begin; i < head; ++i) {
+			copy.push_back(buffer->events[i & (PROFILE_RING_SIZE - 1)]);
+		}
+		uint64_t after = buffer->head.load(std::memory_order_acquire);
+		size_t skip = after - head > copy.size() ? copy.size() : (size_t)(after - head);
+
+		char line[256];
+		for (size_t i = skip; i < copy.size(); ++i) {
+			const ProfileEvent& event = copy[i];
+			snprintf(line, sizeof(line),
+			         ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,"
+			         "\"args\":{\"allocs\":%u,\"bytes\":%u}}",
+			         event.name, buffer->index, event.start / 1000.0, (event.end - event.start) / 1000.0,
+			         event.allocs, event.bytes);
+			json += line;
+		}
+	}
+	json += "\n]}\n";
+
+	bool ok = WriteFileAtomic(path, json.data(), json.size());
+	TraceLog(ok ? LOG_INFO : LOG_WARNING, "PROFILE: trace [%s] %s", path.c_str(), ok ? "已导出" : "写入失败");
+	return ok;
+}
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_BEGIN(name) ProfileBegin(name)
+#define PROFILE_END() ProfileEnd()
+#define PROFILE_FRAME() ProfilerFrame()
+
+#else
+
+#define PROFILE_SCOPE(name)
+#define PROFILE_BEGIN(name)
+#define PROFILE_END()
+#define PROFILE_FRAME()
+
+inline void SetProfileThreadName(const char*) {}
+inline void ToggleProfilerOverlay() {}
+inline bool IsProfilerOverlayVisible() { return false; }
+inline void DrawProfilerOverlay(int = 10, int = 140) {}
+inline bool ExportProfilerTrace(const std::string&) { return false; }
+
+#endif // PROFILER_ENABLED
+
+#endif // PROFILER_H
@@ -0,0 +1,153 @@
+#ifndef RENDERSCALE_H
+#define RENDERSCALE_H
+
+#include "raylib.h"
+#include <cmath>
+
+// ==================== 动态分辨率 ====================
+//
+// 世界层先画到一张内部分辨率的 RenderTexture，再拉伸到窗口；UI 仍按窗口原生分辨率绘制。
+// 内部分辨率 = 窗口大小 × 渲染比例，比例按测得的帧耗时在 [最小, 最大] 之间分档调整：
+// 帧耗时超出目标时降一档，世界层耗时按像素数估算升档后仍有余量时升一档，
+// 每次调整后等一段时间再判断，避免来回跳。
+//
+// 每帧的顺序：
+//   BeginWorldRender(); ClearBackground(...); camera.BeginMode(); ... camera.EndMode(); EndWorldRender();
+//   BeginDrawing(); DrawWorldRender(); ...UI... EndDrawing();
+//   UpdateRenderScale();
+//
+// CameraSystem 保存的是窗口坐标下的相机，只在 BeginWorldRender/EndWorldRender 之间按比例换算
+// （GetRenderCamera），所以鼠标、视野矩形和屏幕/世界坐标换算都与渲染比例无关。
+
+static RenderTexture2D renderTarget = {0};
+static bool renderScaleReady = false;
+static bool renderTargetActive = false; // 在 BeginWorldRender/EndWorldRender 之间
+static bool renderScaleAdaptive = true;
+static float renderScale = 1.0f;        // 目标比例（档位）
+static float renderScaleApplied = 1.0f; // 实际纹理宽度 / 窗口宽度
+static float renderScaleMin = 0.5f;
+static float renderScaleMax = 1.0f;
+static float renderScaleStep = 0.125f;
+static float renderTargetFrameTime = 1.0f / 60.0f;
+static double renderWorldStart = 0.0;
+static float renderFrameAverage = 0.0f; // 帧耗时的滑动平均
+static float renderWorldAverage = 0.0f; // 世界层（含提交）耗时的滑动平均
+static int renderScaleCooldown = 0;
+
+/// 按当前窗口大小和比例（重新）创建内部渲染目标
+static void RefreshRenderTarget() {
+	int screenWidth = GetScreenWidth();
+	int screenHeight = GetScreenHeight();
+	int width = (int)std::lround(screenWidth * renderScale);
+	int height = (int)std::lround(screenHeight * renderScale);
+	if (width < 1) width = 1;
+	if (height < 1) height = 1;
+	if (renderTarget.id != 0 && renderTarget.texture.width == width && renderTarget.texture.height == height) return;
+
+	if (renderTarget.id != 0) UnloadRenderTexture(renderTarget);
+	renderTarget = LoadRenderTexture(width, height);
+	SetTextureFilter(renderTarget.texture, TEXTURE_FILTER_BILINEAR);
+	renderScaleApplied = screenWidth > 0 ? (float)width / screenWidth : 1.0f;
+}
+
+/// 初始化动态分辨率（InitWindow 之后调用；第一次 BeginWorldRender 时也会自动调用）
+void InitRenderScale(float minScale = 0.5f, float maxScale = 1.0f, float targetFrameTime = 1.0f / 60.0f) {
+	renderScaleMin = minScale > 0.1f ? minScale : 0.1f;
+	renderScaleMax = maxScale > renderScaleMin ? maxScale : renderScaleMin;
+	renderTargetFrameTime = targetFrameTime > 0.0f ? targetFrameTime : 1.0f / 60.0f;
+	renderScale = renderScaleMax;
+	renderFrameAverage = renderTargetFrameTime;
+	renderWorldAverage = 0.0f;
+	renderScaleCooldown = 30;
+	renderScaleReady = true;
+	RefreshRenderTarget();
+}
+
+/// 卸载渲染目标（CloseWindow 之前调用）
+void UnloadRenderScale() {
+	if (renderTarget.id != 0) UnloadRenderTexture(renderTarget);
+	renderTarget = {0};
+	renderScaleReady = false;
+}
+
+/// 固定比例并停止自动调整（设置菜单用）；scale <= 0 时恢复自动调整
+void SetRenderScale(float scale) {
+	if (scale <= 0.0f) {
+		renderScaleAdaptive = true;
+		return;
+	}
+	renderScaleAdaptive = false;
+	renderScale = scale;
+	if (renderScaleReady) RefreshRenderTarget();
+}
+
+float GetRenderScale() { return renderScaleApplied; }
+
+/// 开始画世界层：之后的绘制都进入内部渲染目标
+void BeginWorldRender() {
+	if (!renderScaleReady) InitRenderScale();
+	RefreshRenderTarget(); // 窗口大小变化时重建
+	renderWorldStart = GetTime();
+	BeginTextureMode(renderTarget);
+	renderTargetActive = true;
+}
+
+/// 结束世界层（提交批次，软件渲染时耗时主要在这里）
+void EndWorldRender() {
+	EndTextureMode();
+	renderTargetActive = false;
+	float elapsed = (float)(GetTime() - renderWorldStart);
+	renderWorldAverage = renderWorldAverage > 0.0f ? renderWorldAverage * 0.9f + elapsed * 0.1f : elapsed;
+}
+
+/// 在 BeginDrawing 之后调用，把世界层拉伸到整个窗口
+void DrawWorldRender() {
+	if (renderTarget.id == 0) return;
+	// RenderTexture 的纹理上下颠倒
+	Rectangle source = {0, 0, (float)renderTarget.texture.width, -(float)renderTarget.texture.height};
+	Rectangle dest = {0, 0, (float)GetScreenWidth(), (float)GetScreenHeight()};
+	DrawTexturePro(renderTarget.texture, source, dest, {0, 0}, 0.0f, WHITE);
+}
+
+/// 相机在当前绘制目标里使用的参数：在世界层内按渲染比例缩放，其他时候原样返回
+Camera2D GetRenderCamera(const Camera2D& camera) {
+	if (!renderTargetActive) return camera;
+	Camera2D scaled = camera;
+	scaled.offset.x *= renderScaleApplied;
+	scaled.offset.y *= renderScaleApplied;
+	scaled.zoom *= renderScaleApplied;
+	return scaled;
+}
+
+/// 每帧 EndDrawing 之后调用一次：按测得的帧耗时调整比例
+void UpdateRenderScale() {
+	float frameTime = GetFrameTime();
+	renderFrameAverage = renderFrameAverage * 0.9f + frameTime * 0.1f;
+	if (!renderScaleReady || !renderScaleAdaptive) return;
+	if (renderScaleCooldown > 0) {
+		--renderScaleCooldown;
+		return;
+	}
+
+	if (renderFrameAverage > renderTargetFrameTime * 1.15f && renderScale > renderScaleMin) {
+		renderScale = std::fmax(renderScaleMin, renderScale - renderScaleStep);
+		renderScaleCooldown = 30;
+		renderWorldAverage = 0.0f; // 新分辨率下重新测量
+		TraceLog(LOG_INFO, "RENDER: 帧耗时 %.1f ms，渲染比例降到 %.3f", renderFrameAverage * 1000.0f, renderScale);
+		return;
+	}
+
+	if (renderScale < renderScaleMax && renderFrameAverage < renderTargetFrameTime * 1.05f) {
+		// 世界层耗时大致与像素数成正比，升档后仍占不到半帧才升
+		float next = std::fmin(renderScaleMax, renderScale + renderScaleStep);
+		float ratio = next / renderScale;
+		if (renderWorldAverage * ratio * ratio < renderTargetFrameTime * 0.5f) {
+			renderScale = next;
+			renderScaleCooldown = 120; // 升档比降档更谨慎
+			renderWorldAverage = 0.0f;
+			TraceLog(LOG_INFO, "RENDER: 渲染比例升到 %.3f", renderScale);
+		}
+	}
+}
+
+#endif // RENDERSCALE_H
@@ -0,0 +1,203 @@
+#ifndef REWIND_H
+#define REWIND_H
+
+#include "raylib.h"
+#include "snapshot.h"
+#include "character.h"
+#include <vector>
+#include <memory>
+#include <functional>
+#include <cstdint>
+
+// ==================== 回溯缓冲 ====================
+//
+// 每个 tick 记录一帧，环形覆盖最旧的帧。
+// 一帧里只保存状态发生变化的通道: 通道号 u16 | 长度 u16 | SaveState 的输出
+// 每隔 keyframeInterval 帧保存一次全部通道（关键帧），回溯时从目标帧往前
+// 找到最近的关键帧为止，每个通道取最新的一条记录。
+
+/// 一个被跟踪的状态（通常是一个物体或一个系统）
+struct RewindChannel {
+	std::function<void(SnapshotWriter&)> save;
+	std::function<bool(SnapshotReader&)> load;
+	std::vector<unsigned char> last; // 最近一次记录的状态，用于比较是否变化
+	bool recorded;
+};
+
+struct RewindFrame {
+	uint64_t tick;
+	bool keyframe;
+	std::vector<unsigned char> data; // 槽位复用，稳定后不再分配内存
+};
+
+class RewindBuffer {
+private:
+	std::vector<RewindChannel> channels;
+	std::vector<RewindFrame> frames;
+	size_t head;  // 下一帧写入的位置
+	size_t count; // 有效帧数
+	int keyframeInterval;
+	int sinceKeyframe;
+	SnapshotWriter scratch;
+	std::vector<unsigned char> restored; // 回溯时标记已恢复的通道
+
+	RewindFrame& FrameAt(size_t index) { return frames[(head + frames.size() - count + index) % frames.size()]; }
+	int FindFrame(uint64_t tick);
+
+public:
+	explicit RewindBuffer(int capacity = 600, int keyframeEvery = 30);
+
+	// 跟踪任意状态；通道号即注册顺序
+	int Track(std::function<void(SnapshotWriter&)> save, std::function<bool(SnapshotReader&)> load);
+
+	// 跟踪实现了 SaveState/LoadState 的对象（DialogSystem、Character 等）
+	template<typename T>
+	int Track(T& target) {
+		return Track([&target](SnapshotWriter& out) { target.SaveState(out); },
+		             [&target](SnapshotReader& in) { return target.LoadState(in); });
+	}
+
+	// 为 GameObjectSystem 中当前的每个物体各建一个通道，只有动过的物体才会被记录
+	void TrackObjects(GameObjectSystem& system);
+
+	void Record(uint64_t tick); // 每个 tick 结束时调用
+	bool RewindTo(uint64_t tick); // 恢复到不晚于 tick 的最近一帧，并丢弃之后的记录
+	void Clear();
+
+	bool IsEmpty() const { return count == 0; }
+	uint64_t NewestTick() const;
+	uint64_t OldestTick() const; // 仍可恢复的最早一帧（最早的关键帧）
+	size_t MemoryUsage() const;
+};
+
+// ==================== RewindBuffer 实现 ====================
+
+RewindBuffer::RewindBuffer(int capacity, int keyframeEvery)
+: frames(capacity < 2 ? 2 : capacity), head(0), count(0),
+keyframeInterval(keyframeEvery < 1 ? 1 : keyframeEvery), sinceKeyframe(0) {}
+
+int RewindBuffer::Track(std::function<void(SnapshotWriter&)> save, std::function<bool(SnapshotReader&)> load) {
+	channels.push_back({std::move(save), std::move(load), {}, false});
+	restored.push_back(0);
+	return (int)channels.size() - 1;
+}
+
+void RewindBuffer::TrackObjects(GameObjectSystem& system) {
+	for (const auto& [id, obj] : system.GetAllObjects()) {
+		std::weak_ptr<GameObject> weak = obj;
+		Track([weak](SnapshotWriter& out) {
+			if (auto target = weak.lock()) target->SaveState(out);
+		}, [weak](SnapshotReader& in) {
+			auto target = weak.lock();
+			return target ? target->LoadState(in) : false;
+		});
+	}
+}
+
+void RewindBuffer::Record(uint64_t tick) {
+	RewindFrame& frame = frames[head];
+	bool keyframe = count == 0 || sinceKeyframe >= keyframeInterval;
+	frame.tick = tick;
+	frame.keyframe = keyframe;
+	frame.data.clear();
+
+	for (size_t i = 0; i < channels.size(); ++i) {
+		RewindChannel& channel = channels[i];
+		scratch.Clear();
+		channel.save(scratch);
+		const std::vector<unsigned char>& state = scratch.Bytes();
+		if (!keyframe && channel.recorded && state == channel.last) continue;
+
+		uint16_t header[2] = {(uint16_t)i, (uint16_t)state.size()};
+		const unsigned char* raw = (const unsigned char*)header;
+		frame.data.insert(frame.data.end(), raw, raw + sizeof(header));
+		frame.data.insert(frame.data.end(), state.begin(), state.end());
+		channel.last.assign(state.begin(), state.end());
+		channel.recorded = true;
+	}
+
+	sinceKeyframe = keyframe ? 1 : sinceKeyframe + 1;
+	head = (head + 1) % frames.size();
+	if (count < frames.size()) ++count;
+}
+
+int RewindBuffer::FindFrame(uint64_t tick) {
+	// tick 单调递增，二分查找不晚于 tick 的最后一帧
+	int lo = 0;
+	int hi = (int)count - 1;
+	int found = -1;
+	while (lo <= hi) {
+		int mid = lo + (hi - lo) / 2;
+		if (FrameAt(mid).tick <= tick) {
+			found = mid;
+			lo = mid + 1;
+		} else {
+			hi = mid - 1;
+		}
+	}
+	return found;
+}
+
+bool RewindBuffer::RewindTo(uint64_t tick) {
+	int target = FindFrame(tick);
+	int keyframe = target;
+	while (keyframe >= 0 && !FrameAt(keyframe).keyframe) --keyframe;
+	if (keyframe < 0) return false; // 基准关键帧已被覆盖
+
+	std::fill(restored.begin(), restored.end(), 0);
+	for (int index = target; index >= keyframe; --index) {
+		const std::vector<unsigned char>& data = FrameAt(index).data;
+		size_t cursor = 0;
+		while (cursor + 2 * sizeof(uint16_t) <= data.size()) {
+			uint16_t header[2];
+			memcpy(header, data.data() + cursor, sizeof(header));
+			cursor += sizeof(header);
+			const unsigned char* state = data.data() + cursor;
+			cursor += header[1];
+
+			if (header[0] >= channels.size() || restored[header[0]]) continue;
+			restored[header[0]] = 1;
+
+			RewindChannel& channel = channels[header[0]];
+			SnapshotReader in(state, header[1]);
+			channel.load(in);
+			channel.last.assign(state, state + header[1]);
+		}
+	}
+
+	// 丢弃目标之后的帧，之后的记录从这里接着写
+	head = (head + frames.size() - count + target + 1) % frames.size();
+	count = target + 1;
+	sinceKeyframe = target - keyframe + 1;
+	return true;
+}
+
+void RewindBuffer::Clear() {
+	head = 0;
+	count = 0;
+	sinceKeyframe = 0;
+	for (auto& channel : channels) {
+		channel.recorded = false;
+	}
+}
+
+uint64_t RewindBuffer::NewestTick() const {
+	return count ? frames[(head + frames.size() - 1) % frames.size()].tick : 0;
+}
+
+uint64_t RewindBuffer::OldestTick() const {
+	for (size_t i = 0; i < count; ++i) {
+		const RewindFrame& frame = frames[(head + frames.size() - count + i) % frames.size()];
+		if (frame.keyframe) return frame.tick;
+	}
+	return 0;
+}
+
+size_t RewindBuffer::MemoryUsage() const {
+	size_t total = 0;
+	for (const auto& frame : frames) total += frame.data.capacity();
+	for (const auto& channel : channels) total += channel.last.capacity();
+	return total;
+}
+
+#endif // REWIND_H
@@ -0,0 +1,147 @@
+#ifndef SAVEFILE_H
+#define SAVEFILE_H
+
+#include "raylib.h"
+#include <string>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <filesystem>
+#include <system_error>
+#include <cstdio>
+#include <cstdint>
+
+#if defined(_WIN32)
+	#include <io.h>
+#else
+	#include <unistd.h>
+#endif
+
+// ==================== 存档文件工具 ====================
+
+/// FNV-1a 校验，用于发现写了一半的记录
+uint32_t SaveChecksum(const void* data, size_t size, uint32_t hash = 2166136261u) {
+	const unsigned char* bytes = (const unsigned char*)data;
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= bytes[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/// 把缓冲区刷到磁盘，确保断电或崩溃后数据仍在
+static bool SyncSaveFile(FILE* file) {
+	if (fflush(file) != 0) return false;
+#if defined(_WIN32)
+	return _commit(_fileno(file)) == 0;
+#else
+	return fsync(fileno(file)) == 0;
+#endif
+}
+
+/// 原子写入：先写临时文件再改名覆盖，任何时刻磁盘上都是完整的旧文件或新文件
+bool WriteFileAtomic(const std::string& path, const void* data, size_t size) {
+	std::string tmpPath = path + ".tmp";
+	FILE* file = fopen(tmpPath.c_str(), "wb");
+	if (!file) return false;
+
+	bool ok = fwrite(data, 1, size, file) == size && SyncSaveFile(file);
+	fclose(file);
+	if (!ok) {
+		remove(tmpPath.c_str());
+		return false;
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(tmpPath, path, ec); // Windows 下同样会覆盖已有文件
+	if (ec) {
+		TraceLog(LOG_WARNING, "SAVE: [%s] 改名失败: %s", path.c_str(), ec.message().c_str());
+		remove(tmpPath.c_str());
+		return false;
+	}
+	return true;
+}
+
+/// 追加写入并刷盘（用于日志文件）
+bool AppendFileDurable(const std::string& path, const void* data, size_t size) {
+	FILE* file = fopen(path.c_str(), "ab");
+	if (!file) return false;
+	bool ok = fwrite(data, 1, size, file) == size && SyncSaveFile(file);
+	fclose(file);
+	return ok;
+}
+
+// ==================== 后台写入线程 ====================
+
+/// 单线程任务队列：按提交顺序在后台执行磁盘 I/O，主线程只负责投递
+class BackgroundWriter {
+private:
+	std::thread worker;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable idle;
+	std::deque<std::function<void()>> jobs;
+	bool stopping;
+	bool busy;
+
+	void Run();
+
+public:
+	BackgroundWriter() : stopping(false), busy(false) {}
+	~BackgroundWriter() { Stop(); }
+
+	BackgroundWriter(const BackgroundWriter&) = delete;
+	BackgroundWriter& operator=(const BackgroundWriter&) = delete;
+
+	void Post(std::function<void()> job);
+	void Flush(); // 等待已投递的任务全部完成
+	void Stop();  // 完成剩余任务后结束线程
+};
+
+void BackgroundWriter::Run() {
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		wake.wait(lock, [this] { return stopping || !jobs.empty(); });
+		if (jobs.empty()) return; // stopping 且没有剩余任务
+
+		std::function<void()> job = std::move(jobs.front());
+		jobs.pop_front();
+		busy = true;
+		lock.unlock();
+		job();
+		lock.lock();
+		busy = false;
+		if (jobs.empty()) idle.notify_all();
+	}
+}
+
+void BackgroundWriter::Post(std::function<void()> job) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!worker.joinable()) {
+			stopping = false;
+			worker = std::thread(&BackgroundWriter::Run, this);
+		}
+		jobs.push_back(std::move(job));
+	}
+	wake.notify_one();
+}
+
+void BackgroundWriter::Flush() {
+	std::unique_lock<std::mutex> lock(mutex);
+	idle.wait(lock, [this] { return jobs.empty() && !busy; });
+}
+
+void BackgroundWriter::Stop() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!worker.joinable()) return;
+		stopping = true;
+	}
+	wake.notify_all();
+	worker.join();
+}
+
+#endif // SAVEFILE_H
@@ -0,0 +1,558 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include "raylib.h"
+#include "assetpack.h"
+#include "character.h"
+#include "interaction.h"
+#include "framemem.h"
+#include "profiler.h"
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cstdint>
+#include <cmath>
+
+// ==================== 场景文本格式 ====================
+//
+// # 注释
+// spawn <x> <y>                                    玩家出生点
+// grid <格子边长>                                  碰撞网格的格子边长（默认 128）
+// box <x> <y> <宽> <高> <是否实心 0/1> <颜色> [名称]  常驻碰撞箱（世界坐标）
+// object <id> <贴图路径> <x> <y> [缩放]             图片物体
+// collide <x> <y> <宽> <高> <是否实心 0/1> <颜色> [名称]
+//                                                  属于上一个 object 的碰撞箱（物体局部坐标）
+// tag <标签> [标签 ...]                             给上一个 object 加标签（见 character.h）
+// interact <x> <y> <距离> <对话编号> [事件名]         可交互点（见 interaction.h）
+// trigger <x> <y> <宽> <高> <对话编号> [事件名]       触发区
+//
+// 颜色写 raylib 的颜色名（RED、DARKGRAY ...）或 #RRGGBB / #RRGGBBAA。
+//
+// ==================== 场景二进制格式 ====================
+//
+// [SceneHeader]
+// [SceneBoxRecord * boxCount]
+// [SceneObjectRecord * objectCount]       按 id 排序
+// [SceneComponentRecord * componentCount] 每个物体的碰撞箱连续存放
+// [uint32 * tagRefCount]                  每个物体的标签连续存放（字符串表下标）
+// [SceneInteractRecord * interactCount]
+// [SceneTriggerRecord * triggerCount]
+// [SceneStringEntry * stringCount]        字符串表（相同字符串只存一份）
+// [字符串数据]
+// [uint32 * (gridCols * gridRows + 1)]    碰撞网格（BroadphaseGrid 的 cellStart）
+// [uint32 * gridItemCount]                碰撞网格（BroadphaseGrid 的 items，即 box 下标）
+//
+// 所有整数均为小端序，所有记录按 4 字节对齐。加载时按记录批量创建物体、碰撞箱和交互项，
+// 碰撞网格直接交给 CollisionSystem，不再逐行解析也不再重建索引。
+
+static const char SCENE_MAGIC[4] = {'N', 'B', 'S', 'C'};
+static const uint32_t SCENE_VERSION = 3;
+static const uint32_t SCENE_NO_STRING = 0xFFFFFFFFu;
+
+struct SceneHeader {
+	char magic[4];
+	uint32_t version;
+	float spawnX;
+	float spawnY;
+	uint32_t hasSpawn;
+	uint32_t boxCount;
+	uint32_t boxesOffset;
+	uint32_t objectCount;
+	uint32_t objectsOffset;
+	uint32_t componentCount;
+	uint32_t componentsOffset;
+	uint32_t tagRefCount;
+	uint32_t tagRefsOffset;
+	uint32_t interactCount;
+	uint32_t interactsOffset;
+	uint32_t triggerCount;
+	uint32_t triggersOffset;
+	uint32_t stringCount;
+	uint32_t stringsOffset;
+	uint32_t stringDataOffset;
+	uint32_t stringDataSize;
+	float gridBounds[4];
+	float gridCellSize;
+	int32_t gridCols;
+	int32_t gridRows;
+	uint32_t gridCellsOffset;
+	uint32_t gridItemCount;
+	uint32_t gridItemsOffset;
+};
+
+struct SceneStringEntry {
+	uint32_t offset; // 相对于字符串数据
+	uint32_t length;
+};
+
+struct SceneBoxRecord {
+	float rect[4];
+	uint32_t color; // RGBA 打包，r 在最低字节
+	uint32_t solid;
+	uint32_t name;
+};
+
+struct SceneObjectRecord {
+	uint32_t id;
+	uint32_t texture;
+	float x;
+	float y;
+	float scale;
+	uint32_t firstComponent;
+	uint32_t componentCount;
+	uint32_t firstTag;
+	uint32_t tagCount;
+};
+
+struct SceneComponentRecord {
+	float rect[4];
+	uint32_t color;
+	uint32_t solid;
+	uint32_t name;
+};
+
+struct SceneInteractRecord {
+	float x;
+	float y;
+	float reach;
+	int32_t dialogId;
+	uint32_t event;
+};
+
+struct SceneTriggerRecord {
+	float rect[4];
+	int32_t dialogId;
+	uint32_t event;
+};
+
+/// 加载结果
+struct SceneInfo {
+	Vector2 spawn = {0, 0};
+	bool hasSpawn = false;
+	int boxCount = 0;
+	int objectCount = 0;
+	int interactCount = 0;
+	int triggerCount = 0;
+};
+
+static uint32_t PackSceneColor(Color color) {
+	return (uint32_t)color.r | ((uint32_t)color.g << 8) | ((uint32_t)color.b << 16) | ((uint32_t)color.a << 24);
+}
+
+static Color UnpackSceneColor(uint32_t packed) {
+	return {(unsigned char)(packed & 0xFF), (unsigned char)((packed >> 8) & 0xFF),
+	        (unsigned char)((packed >> 16) & 0xFF), (unsigned char)(packed >> 24)};
+}
+
+/// 颜色名或 #RRGGBB[AA]
+static bool ParseSceneColor(const std::string& text, Color& color) {
+	static const std::unordered_map<std::string, Color> names = {
+		{"LIGHTGRAY", LIGHTGRAY}, {"GRAY", GRAY}, {"DARKGRAY", DARKGRAY}, {"YELLOW", YELLOW},
+		{"GOLD", GOLD}, {"ORANGE", ORANGE}, {"PINK", PINK}, {"RED", RED}, {"MAROON", MAROON},
+		{"GREEN", GREEN}, {"LIME", LIME}, {"DARKGREEN", DARKGREEN}, {"SKYBLUE", SKYBLUE},
+		{"BLUE", BLUE}, {"DARKBLUE", DARKBLUE}, {"PURPLE", PURPLE}, {"VIOLET", VIOLET},
+		{"DARKPURPLE", DARKPURPLE}, {"BEIGE", BEIGE}, {"BROWN", BROWN}, {"DARKBROWN", DARKBROWN},
+		{"WHITE", WHITE}, {"BLACK", BLACK}, {"MAGENTA", MAGENTA}, {"RAYWHITE", RAYWHITE}
+	};
+	if (!text.empty() && text[0] == '#' && (text.size() == 7 || text.size() == 9)) {
+		char* end = nullptr;
+		unsigned long value = strtoul(text.c_str() + 1, &end, 16);
+		if (*end != '\0') return false;
+		if (text.size() == 7) value = (value << 8) | 0xFF;
+		color = {(unsigned char)(value >> 24), (unsigned char)(value >> 16), (unsigned char)(value >> 8), (unsigned char)value};
+		return true;
+	}
+	auto it = names.find(text);
+	if (it == names.end()) return false;
+	color = it->second;
+	return true;
+}
+
+/// 把文本场景编译为二进制，失败时 error 给出行号和原因
+bool CompileScene(const std::string& source, std::vector<unsigned char>& out, std::string& error) {
+	std::vector<std::string> strings;
+	std::unordered_map<std::string, uint32_t> interned;
+	auto intern = [&](const std::string& value) -> uint32_t {
+		if (value.empty()) return SCENE_NO_STRING;
+		auto it = interned.find(value);
+		if (it != interned.end()) return it->second;
+		uint32_t index = (uint32_t)strings.size();
+		strings.push_back(value);
+		interned[value] = index;
+		return index;
+	};
+
+	struct SourceObject {
+		SceneObjectRecord record;
+		std::string id;
+		std::vector<SceneComponentRecord> components;
+		std::vector<uint32_t> tags;
+	};
+
+	SceneHeader header = {};
+	memcpy(header.magic, SCENE_MAGIC, 4);
+	header.version = SCENE_VERSION;
+	float cellSize = 128.0f;
+	std::vector<SceneBoxRecord> boxes;
+	std::vector<SourceObject> objects;
+	std::vector<SceneInteractRecord> interacts;
+	std::vector<SceneTriggerRecord> triggers;
+	std::unordered_map<std::string, int> objectLines;
+
+	std::istringstream lines(source);
+	std::string line;
+	int lineNumber = 0;
+	auto fail = [&](const std::string& message) {
+		error = "第 " + std::to_string(lineNumber) + " 行: " + message;
+		return false;
+	};
+	while (std::getline(lines, line)) {
+		++lineNumber;
+		if (!line.empty() && line.back() == '\r') line.pop_back();
+		std::istringstream in(line);
+		std::string kind;
+		if (!(in >> kind) || kind[0] == '#') continue;
+
+		if (kind == "spawn") {
+			if (!(in >> header.spawnX >> header.spawnY)) return fail("spawn 需要 x y");
+			header.hasSpawn = 1;
+		} else if (kind == "grid") {
+			if (!(in >> cellSize) || cellSize < 1.0f) return fail("grid 需要正数的格子边长");
+		} else if (kind == "box" || kind == "collide") {
+			float rect[4];
+			int solid = 1;
+			std::string colorName, name;
+			Color color;
+			if (!(in >> rect[0] >> rect[1] >> rect[2] >> rect[3] >> solid >> colorName)) {
+				return fail(kind + " 需要 x y 宽 高 是否实心 颜色");
+			}
+			if (!ParseSceneColor(colorName, color)) return fail("无法识别的颜色 " + colorName);
+			std::getline(in >> std::ws, name);
+			if (kind == "box") {
+				SceneBoxRecord box = {{rect[0], rect[1], rect[2], rect[3]}, PackSceneColor(color), (uint32_t)(solid != 0), intern(name)};
+				boxes.push_back(box);
+			} else {
+				if (objects.empty()) return fail("collide 之前没有 object");
+				SceneComponentRecord component = {{rect[0], rect[1], rect[2], rect[3]}, PackSceneColor(color), (uint32_t)(solid != 0), intern(name)};
+				objects.back().components.push_back(component);
+			}
+		} else if (kind == "tag") {
+			if (objects.empty()) return fail("tag 之前没有 object");
+			std::string name;
+			while (in >> name) objects.back().tags.push_back(intern(name));
+			if (objects.back().tags.empty()) return fail("tag 需要至少一个标签名");
+		} else if (kind == "interact") {
+			SceneInteractRecord interact = {};
+			std::string event;
+			if (!(in >> interact.x >> interact.y >> interact.reach >> interact.dialogId)) {
+				return fail("interact 需要 x y 距离 对话编号");
+			}
+			std::getline(in >> std::ws, event);
+			interact.event = intern(event);
+			interacts.push_back(interact);
+		} else if (kind == "trigger") {
+			SceneTriggerRecord trigger = {};
+			std::string event;
+			if (!(in >> trigger.rect[0] >> trigger.rect[1] >> trigger.rect[2] >> trigger.rect[3] >> trigger.dialogId)) {
+				return fail("trigger 需要 x y 宽 高 对话编号");
+			}
+			std::getline(in >> std::ws, event);
+			trigger.event = intern(event);
+			triggers.push_back(trigger);
+		} else if (kind == "object") {
+			SourceObject object;
+			std::string texture;
+			object.record = {};
+			object.record.scale = 1.0f;
+			if (!(in >> object.id >> texture >> object.record.x >> object.record.y)) {
+				return fail("object 需要 id 贴图路径 x y");
+			}
+			float scale;
+			if (in >> scale) object.record.scale = scale;
+			if (!objectLines.emplace(object.id, lineNumber).second) {
+				return fail("重复的物体 id " + object.id);
+			}
+			object.record.id = intern(object.id);
+			object.record.texture = intern(texture);
+			objects.push_back(std::move(object));
+		} else {
+			return fail("未知的记录类型 " + kind);
+		}
+	}
+
+	// 物体按 id 排序，加载时可以顺序插入
+	std::sort(objects.begin(), objects.end(), [](const SourceObject& a, const SourceObject& b) {
+		return a.id < b.id;
+	});
+	std::vector<SceneComponentRecord> components;
+	std::vector<uint32_t> tagRefs;
+	for (auto& object : objects) {
+		object.record.firstComponent = (uint32_t)components.size();
+		object.record.componentCount = (uint32_t)object.components.size();
+		components.insert(components.end(), object.components.begin(), object.components.end());
+		object.record.firstTag = (uint32_t)tagRefs.size();
+		object.record.tagCount = (uint32_t)object.tags.size();
+		tagRefs.insert(tagRefs.end(), object.tags.begin(), object.tags.end());
+	}
+
+	BroadphaseGrid grid;
+	BuildBroadphaseGrid(boxes.size(), [&boxes](size_t i, Rectangle& rect) {
+		rect = {boxes[i].rect[0], boxes[i].rect[1], boxes[i].rect[2], boxes[i].rect[3]};
+		return boxes[i].solid != 0;
+	}, cellSize, grid);
+
+	std::vector<SceneStringEntry> stringEntries;
+	std::string stringData;
+	for (const auto& value : strings) {
+		stringEntries.push_back({(uint32_t)stringData.size(), (uint32_t)value.size()});
+		stringData += value;
+	}
+	header.stringDataSize = (uint32_t)stringData.size();
+	while (stringData.size() % 4) stringData += '\0';
+
+	// 计算各段偏移
+	header.boxCount = (uint32_t)boxes.size();
+	header.boxesOffset = sizeof(SceneHeader);
+	header.objectCount = (uint32_t)objects.size();
+	header.objectsOffset = header.boxesOffset + header.boxCount * sizeof(SceneBoxRecord);
+	header.componentCount = (uint32_t)components.size();
+	header.componentsOffset = header.objectsOffset + header.objectCount * sizeof(SceneObjectRecord);
+	header.tagRefCount = (uint32_t)tagRefs.size();
+	header.tagRefsOffset = header.componentsOffset + header.componentCount * sizeof(SceneComponentRecord);
+	header.interactCount = (uint32_t)interacts.size();
+	header.interactsOffset = header.tagRefsOffset + header.tagRefCount * sizeof(uint32_t);
+	header.triggerCount = (uint32_t)triggers.size();
+	header.triggersOffset = header.interactsOffset + header.interactCount * sizeof(SceneInteractRecord);
+	header.stringCount = (uint32_t)strings.size();
+	header.stringsOffset = header.triggersOffset + header.triggerCount * sizeof(SceneTriggerRecord);
+	header.stringDataOffset = header.stringsOffset + header.stringCount * sizeof(SceneStringEntry);
+	header.gridBounds[0] = grid.bounds.x;
+	header.gridBounds[1] = grid.bounds.y;
+	header.gridBounds[2] = grid.bounds.width;
+	header.gridBounds[3] = grid.bounds.height;
+	header.gridCellSize = grid.cellSize;
+	header.gridCols = grid.cols;
+	header.gridRows = grid.rows;
+	header.gridCellsOffset = header.stringDataOffset + (uint32_t)stringData.size();
+	header.gridItemCount = (uint32_t)grid.items.size();
+	header.gridItemsOffset = header.gridCellsOffset + (uint32_t)(grid.cellStart.size() * sizeof(uint32_t));
+
+	out.clear();
+	out.reserve(header.gridItemsOffset + grid.items.size() * sizeof(uint32_t));
+	auto append = [&out](const void* data, size_t size) {
+		const unsigned char* bytes = (const unsigned char*)data;
+		out.insert(out.end(), bytes, bytes + size);
+	};
+	append(&header, sizeof(header));
+	append(boxes.data(), boxes.size() * sizeof(SceneBoxRecord));
+	for (const auto& object : objects) {
+		append(&object.record, sizeof(SceneObjectRecord));
+	}
+	append(components.data(), components.size() * sizeof(SceneComponentRecord));
+	append(tagRefs.data(), tagRefs.size() * sizeof(uint32_t));
+	append(interacts.data(), interacts.size() * sizeof(SceneInteractRecord));
+	append(triggers.data(), triggers.size() * sizeof(SceneTriggerRecord));
+	append(stringEntries.data(), stringEntries.size() * sizeof(SceneStringEntry));
+	append(stringData.data(), stringData.size());
+	append(grid.cellStart.data(), grid.cellStart.size() * sizeof(uint32_t));
+	append(grid.items.data(), grid.items.size() * sizeof(uint32_t));
+	return true;
+}
+
+// ==================== 运行时加载 ====================
+
+/// 检查二进制场景的各段是否在数据范围内
+static bool ValidateScene(const unsigned char* data, size_t size) {
+	const SceneHeader* h = (const SceneHeader*)data;
+	if (!data || size < sizeof(SceneHeader) || memcmp(h->magic, SCENE_MAGIC, 4) != 0 || h->version != SCENE_VERSION) {
+		return false;
+	}
+	uint64_t gridCells = h->gridCols > 0 && h->gridRows > 0 ? (uint64_t)h->gridCols * h->gridRows + 1 : 0;
+	if ((uint64_t)h->boxesOffset + (uint64_t)h->boxCount * sizeof(SceneBoxRecord) > size ||
+		(uint64_t)h->objectsOffset + (uint64_t)h->objectCount * sizeof(SceneObjectRecord) > size ||
+		(uint64_t)h->componentsOffset + (uint64_t)h->componentCount * sizeof(SceneComponentRecord) > size ||
+		(uint64_t)h->tagRefsOffset + (uint64_t)h->tagRefCount * sizeof(uint32_t) > size ||
+		(uint64_t)h->interactsOffset + (uint64_t)h->interactCount * sizeof(SceneInteractRecord) > size ||
+		(uint64_t)h->triggersOffset + (uint64_t)h->triggerCount * sizeof(SceneTriggerRecord) > size ||
+		(uint64_t)h->stringsOffset + (uint64_t)h->stringCount * sizeof(SceneStringEntry) > size ||
+		(uint64_t)h->stringDataOffset + h->stringDataSize > size ||
+		(uint64_t)h->gridCellsOffset + gridCells * sizeof(uint32_t) > size ||
+		(uint64_t)h->gridItemsOffset + (uint64_t)h->gridItemCount * sizeof(uint32_t) > size) {
+		return false;
+	}
+	const SceneStringEntry* strings = (const SceneStringEntry*)(data + h->stringsOffset);
+	for (uint32_t i = 0; i < h->stringCount; ++i) {
+		if ((uint64_t)strings[i].offset + strings[i].length > h->stringDataSize) return false;
+	}
+	const SceneObjectRecord* objects = (const SceneObjectRecord*)(data + h->objectsOffset);
+	for (uint32_t i = 0; i < h->objectCount; ++i) {
+		if ((uint64_t)objects[i].firstComponent + objects[i].componentCount > h->componentCount ||
+			(uint64_t)objects[i].firstTag + objects[i].tagCount > h->tagRefCount) {
+			return false;
+		}
+	}
+	const uint32_t* tagRefs = (const uint32_t*)(data + h->tagRefsOffset);
+	for (uint32_t i = 0; i < h->tagRefCount; ++i) {
+		if (tagRefs[i] >= h->stringCount) return false;
+	}
+	const uint32_t* items = (const uint32_t*)(data + h->gridItemsOffset);
+	for (uint32_t i = 0; i < h->gridItemCount; ++i) {
+		if (items[i] >= h->boxCount) return false;
+	}
+	// 碰撞网格会原样交给 CollisionSystem，查询时不再检查：格子边长和包围盒必须是有限正数，
+	// 行列数盖得住包围盒，cellStart 从 0 开始不递减，最后一项等于 items 的数量
+	if (gridCells > 0) {
+		const float* b = h->gridBounds;
+		if (!(h->gridCellSize >= 1.0f) || !std::isfinite(h->gridCellSize) ||
+			!std::isfinite(b[0]) || !std::isfinite(b[1]) || !(b[2] >= 0.0f) || !(b[3] >= 0.0f) ||
+			!std::isfinite(b[2]) || !std::isfinite(b[3]) ||
+			(double)b[2] / h->gridCellSize >= h->gridCols || (double)b[3] / h->gridCellSize >= h->gridRows) {
+			return false;
+		}
+		const uint32_t* cells = (const uint32_t*)(data + h->gridCellsOffset);
+		if (cells[0] != 0 || cells[gridCells - 1] != h->gridItemCount) return false;
+		for (uint64_t i = 1; i < gridCells; ++i) {
+			if (cells[i] < cells[i - 1]) return false;
+		}
+	}
+	return true;
+}
+
+/// 按记录批量创建碰撞箱、物体和交互项（数据已通过 ValidateScene）
+static void InstantiateScene(const unsigned char* data, CollisionSystem* collisions, GameObjectSystem* objects,
+                             SceneInfo* info, InteractionSystem* interactions) {
+	PROFILE_SCOPE("scene instantiate");
+	AllowFrameAllocations();
+	const SceneHeader* h = (const SceneHeader*)data;
+	const SceneStringEntry* strings = (const SceneStringEntry*)(data + h->stringsOffset);
+	const char* stringData = (const char*)(data + h->stringDataOffset);
+	auto text = [&](uint32_t id) -> std::string {
+		if (id >= h->stringCount) return std::string();
+		return std::string(stringData + strings[id].offset, strings[id].length);
+	};
+
+	// 碰撞网格的下标从 0 开始，只有碰撞系统原本为空时才能直接使用
+	bool adoptGrid = collisions && collisions->GetCollisionBoxes().empty() && h->gridCols > 0 && h->gridRows > 0;
+	const SceneBoxRecord* boxes = (const SceneBoxRecord*)(data + h->boxesOffset);
+	if (!collisions && h->boxCount > 0) {
+		TraceLog(LOG_WARNING, "SCENE: 没有提供 CollisionSystem，跳过 %d 个碰撞箱", (int)h->boxCount);
+	}
+	if (collisions) collisions->Reserve(collisions->GetCollisionBoxes().size() + h->boxCount);
+	for (uint32_t i = 0; collisions && i < h->boxCount; ++i) {
+		const SceneBoxRecord& box = boxes[i];
+		collisions->AddCollisionBox({box.rect[0], box.rect[1], box.rect[2], box.rect[3]},
+		                            UnpackSceneColor(box.color), box.solid != 0, text(box.name));
+	}
+	if (adoptGrid) {
+		BroadphaseGrid grid;
+		grid.bounds = {h->gridBounds[0], h->gridBounds[1], h->gridBounds[2], h->gridBounds[3]};
+		grid.cellSize = h->gridCellSize;
+		grid.cols = h->gridCols;
+		grid.rows = h->gridRows;
+		const uint32_t* cells = (const uint32_t*)(data + h->gridCellsOffset);
+		const uint32_t* items = (const uint32_t*)(data + h->gridItemsOffset);
+		grid.cellStart.assign(cells, cells + (size_t)grid.cols * grid.rows + 1);
+		grid.items.assign(items, items + h->gridItemCount);
+		collisions->AdoptBroadphase(std::move(grid));
+	}
+
+	const SceneObjectRecord* records = (const SceneObjectRecord*)(data + h->objectsOffset);
+	const SceneComponentRecord* components = (const SceneComponentRecord*)(data + h->componentsOffset);
+	const uint32_t* tagRefs = (const uint32_t*)(data + h->tagRefsOffset);
+	std::vector<TagId> stringTags; // 字符串表下标 -> 标签，同名标签只登记一次
+	if (objects && h->tagRefCount > 0) stringTags.assign(h->stringCount, NO_TAG);
+	if (!objects && h->objectCount > 0) {
+		TraceLog(LOG_WARNING, "SCENE: 没有提供 GameObjectSystem，跳过 %d 个物体", (int)h->objectCount);
+	}
+	for (uint32_t i = 0; objects && i < h->objectCount; ++i) {
+		const SceneObjectRecord& record = records[i];
+		std::string id = text(record.id);
+		auto object = std::make_shared<ImageObject>(text(record.texture), id);
+		object->SetPosition({record.x, record.y});
+		object->SetScale(record.scale);
+		for (uint32_t k = 0; k < record.componentCount; ++k) {
+			const SceneComponentRecord& component = components[record.firstComponent + k];
+			object->AddCollisionComponent({component.rect[0], component.rect[1], component.rect[2], component.rect[3]},
+			                              UnpackSceneColor(component.color), component.solid != 0, text(component.name));
+		}
+		for (uint32_t k = 0; k < record.tagCount; ++k) {
+			uint32_t name = tagRefs[record.firstTag + k];
+			if (stringTags[name] == NO_TAG) stringTags[name] = InternTag(text(name));
+			object->AddTag(stringTags[name]);
+		}
+		objects->AddObject(id, object);
+	}
+
+	const SceneInteractRecord* interacts = (const SceneInteractRecord*)(data + h->interactsOffset);
+	const SceneTriggerRecord* triggers = (const SceneTriggerRecord*)(data + h->triggersOffset);
+	// 交互项是可选内容：不关心交互的入口（如 main_1）传空指针，静默跳过
+	for (uint32_t i = 0; interactions && i < h->interactCount; ++i) {
+		const SceneInteractRecord& interact = interacts[i];
+		interactions->AddInteractable({interact.x, interact.y}, interact.reach, interact.dialogId, text(interact.event));
+	}
+	for (uint32_t i = 0; interactions && i < h->triggerCount; ++i) {
+		const SceneTriggerRecord& trigger = triggers[i];
+		interactions->AddTrigger({trigger.rect[0], trigger.rect[1], trigger.rect[2], trigger.rect[3]},
+		                         trigger.dialogId, text(trigger.event));
+	}
+
+	if (info) {
+		info->spawn = {h->spawnX, h->spawnY};
+		info->hasSpawn = h->hasSpawn != 0;
+		info->boxCount = (int)h->boxCount;
+		info->objectCount = (int)h->objectCount;
+		info->interactCount = (int)h->interactCount;
+		info->triggerCount = (int)h->triggerCount;
+	}
+}
+
+/// 加载编译好的二进制场景：优先取资源包中的条目，否则映射独立文件。collisions/objects/interactions 为空时跳过对应内容
+bool LoadScene(const std::string& path, CollisionSystem* collisions, GameObjectSystem* objects, SceneInfo* info = nullptr,
+               InteractionSystem* interactions = nullptr) {
+	PackData packed = assetPack.Load(path);
+	MappedFile file;
+	const unsigned char* data = packed.data;
+	size_t size = (size_t)packed.size;
+	if (!data) {
+		if (!file.Open(path.c_str())) return false;
+		data = file.Data();
+		size = file.Size();
+	}
+	bool valid = ValidateScene(data, size);
+	if (valid) {
+		InstantiateScene(data, collisions, objects, info, interactions);
+		const SceneHeader* h = (const SceneHeader*)data;
+		// 每次加载都会打印，用 DEBUG 级别，免得反复加载（基准测试、流式切换）时刷屏
+		TraceLog(LOG_DEBUG, "SCENE: [%s] %d 个碰撞箱, %d 个物体, %d 个可交互点, %d 个触发区", path.c_str(),
+		         (int)h->boxCount, (int)h->objectCount, (int)h->interactCount, (int)h->triggerCount);
+	} else {
+		TraceLog(LOG_WARNING, "SCENE: [%s] 不是有效的场景文件", path.c_str());
+	}
+	UnloadPackData(packed);
+	return valid;
+}
+
+/// 没有编译好的二进制时，读取文本场景并在内存中编译
+bool LoadSceneSource(const std::string& path, CollisionSystem* collisions, GameObjectSystem* objects, SceneInfo* info = nullptr,
+                     InteractionSystem* interactions = nullptr) {
+	char* source = LoadFileText(path.c_str());
+	if (!source) return false;
+
+	std::vector<unsigned char> compiled;
+	std::string error;
+	bool ok = CompileScene(source, compiled, error);
+	UnloadFileText(source);
+	if (!ok) {
+		TraceLog(LOG_WARNING, "SCENE: [%s] %s", path.c_str(), error.c_str());
+		return false;
+	}
+	InstantiateScene(compiled.data(), collisions, objects, info, interactions);
+	return true;
+}
+
+#endif // SCENE_H
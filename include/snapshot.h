@@ -0,0 +1,237 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "raylib.h"
+#include "savefile.h"
+#include "framemem.h"
+#include <string>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+
+// ==================== 存档快照格式 ====================
+//
+// [SnapshotFileHeader]
+// [数据]          flags 含 SNAPSHOT_FLAG_DEFLATE 时为压缩后的数据
+//
+// 解压后的数据由若干数据块组成，每块: 标签 u32 | 长度 u32 | 内容
+// 读取时按标签查找，不认识的块直接跳过，所以新增系统不会破坏旧存档。
+
+static const char SNAPSHOT_MAGIC[4] = {'N', 'B', 'S', 'V'};
+static const uint32_t SNAPSHOT_VERSION = 1;
+static const uint32_t SNAPSHOT_FLAG_DEFLATE = 1u << 0;
+
+// 顶层数据块标签
+static const uint32_t SNAP_OBJECTS = 1;     // GameObjectSystem
+static const uint32_t SNAP_PLAYER = 2;      // 不在 GameObjectSystem 中的玩家角色
+static const uint32_t SNAP_DIALOG = 3;      // DialogSystem
+static const uint32_t SNAP_ACHIEVEMENT = 4; // AchievementSystem
+static const uint32_t SNAP_OBJECT = 16;     // GameObjectSystem 内的单个物体
+static const uint32_t SNAP_USER = 256;      // 从这里开始留给各个 main 自定义
+
+struct SnapshotFileHeader {
+	char magic[4];
+	uint32_t version;
+	uint32_t flags;
+	uint32_t rawSize;    // 解压后大小
+	uint32_t storedSize; // 文件中数据大小
+	uint32_t checksum;   // 解压后数据的校验
+};
+
+// ==================== 快照写入 ====================
+
+class SnapshotWriter {
+private:
+	std::vector<unsigned char> bytes;
+	std::vector<size_t> openBlocks; // 未结束的数据块长度字段位置
+
+public:
+	template<typename T>
+	void Write(const T& value) {
+		static_assert(std::is_trivially_copyable<T>::value, "只能直接写入平凡类型");
+		const unsigned char* raw = (const unsigned char*)&value;
+		bytes.insert(bytes.end(), raw, raw + sizeof(T));
+	}
+
+	void WriteString(const std::string& text) {
+		Write((uint32_t)text.size());
+		bytes.insert(bytes.end(), text.begin(), text.end());
+	}
+
+	void BeginBlock(uint32_t tag) {
+		Write(tag);
+		openBlocks.push_back(bytes.size());
+		Write((uint32_t)0); // 长度在 EndBlock 时回填
+	}
+
+	void EndBlock() {
+		size_t lengthPos = openBlocks.back();
+		openBlocks.pop_back();
+		uint32_t length = (uint32_t)(bytes.size() - lengthPos - sizeof(uint32_t));
+		memcpy(bytes.data() + lengthPos, &length, sizeof(length));
+	}
+
+	const std::vector<unsigned char>& Bytes() const { return bytes; }
+	std::vector<unsigned char> Release() { return std::move(bytes); }
+
+	// 清空内容但保留容量，便于每帧复用
+	void Clear() {
+		bytes.clear();
+		openBlocks.clear();
+	}
+};
+
+// ==================== 快照读取 ====================
+
+class SnapshotReader {
+private:
+	const unsigned char* data;
+	size_t size;
+	size_t cursor;
+	bool ok;
+
+public:
+	SnapshotReader() : data(nullptr), size(0), cursor(0), ok(false) {}
+	SnapshotReader(const unsigned char* d, size_t s) : data(d), size(s), cursor(0), ok(true) {}
+
+	template<typename T>
+	bool Read(T& value) {
+		static_assert(std::is_trivially_copyable<T>::value, "只能直接读取平凡类型");
+		if (!ok || size - cursor < sizeof(T)) {
+			ok = false;
+			return false;
+		}
+		memcpy(&value, data + cursor, sizeof(T));
+		cursor += sizeof(T);
+		return true;
+	}
+
+	bool ReadString(std::string& text) {
+		uint32_t length = 0;
+		if (!Read(length) || size - cursor < length) {
+			ok = false;
+			return false;
+		}
+		text.assign((const char*)data + cursor, length);
+		cursor += length;
+		return true;
+	}
+
+	// 读取下一个数据块（块内容作为独立的读取器）
+	bool NextBlock(uint32_t& tag, SnapshotReader& block) {
+		uint32_t length = 0;
+		if (!Read(tag) || !Read(length) || size - cursor < length) {
+			ok = false;
+			return false;
+		}
+		block = SnapshotReader(data + cursor, length);
+		cursor += length;
+		return true;
+	}
+
+	// 从头查找指定标签的数据块
+	bool FindBlock(uint32_t tag, SnapshotReader& block) const {
+		SnapshotReader scan(data, size);
+		uint32_t found = 0;
+		while (!scan.AtEnd() && scan.NextBlock(found, block)) {
+			if (found == tag) return true;
+		}
+		return false;
+	}
+
+	bool IsOk() const { return ok; }
+	bool AtEnd() const { return cursor >= size; }
+};
+
+// ==================== 异步存档 ====================
+
+// 后台存档线程：压缩、校验、写盘都不占用游戏帧
+static BackgroundWriter snapshotWriter;
+static std::atomic<int> snapshotPending(0);
+
+/// 把已采集的快照交给后台线程压缩并原子写盘，主线程只移交缓冲区
+void SaveSnapshotAsync(const std::string& path, SnapshotWriter& snapshot) {
+	AllowFrameAllocations(); // 存档、读档是一次性事件
+	auto payload = std::make_shared<std::vector<unsigned char>>(snapshot.Release());
+	++snapshotPending;
+	snapshotWriter.Post([path, payload] {
+		SnapshotFileHeader header;
+		memcpy(header.magic, SNAPSHOT_MAGIC, 4);
+		header.version = SNAPSHOT_VERSION;
+		header.flags = 0;
+		header.rawSize = (uint32_t)payload->size();
+		header.checksum = SaveChecksum(payload->data(), payload->size());
+
+		const unsigned char* stored = payload->data();
+		int storedSize = (int)payload->size();
+		int compSize = 0;
+		unsigned char* comp = payload->empty() ? nullptr : CompressData(payload->data(), (int)payload->size(), &compSize);
+		if (comp && compSize > 0 && compSize < storedSize) {
+			stored = comp;
+			storedSize = compSize;
+			header.flags |= SNAPSHOT_FLAG_DEFLATE;
+		}
+		header.storedSize = (uint32_t)storedSize;
+
+		std::vector<unsigned char> file(sizeof(header) + storedSize);
+		memcpy(file.data(), &header, sizeof(header));
+		if (storedSize > 0) memcpy(file.data() + sizeof(header), stored, storedSize);
+		if (comp) MemFree(comp);
+
+		if (!WriteFileAtomic(path, file.data(), file.size())) {
+			TraceLog(LOG_WARNING, "SNAPSHOT: [%s] 写入失败", path.c_str());
+		}
+		--snapshotPending;
+	});
+}
+
+/// 读取快照文件，成功时 payload 为解压后的数据块序列
+bool LoadSnapshot(const std::string& path, std::vector<unsigned char>& payload) {
+	AllowFrameAllocations();
+	int size = 0;
+	unsigned char* data = LoadFileData(path.c_str(), &size);
+	if (!data) return false;
+
+	SnapshotFileHeader header;
+	bool valid = size >= (int)sizeof(header);
+	if (valid) {
+		memcpy(&header, data, sizeof(header));
+		valid = memcmp(header.magic, SNAPSHOT_MAGIC, 4) == 0 && header.version == SNAPSHOT_VERSION &&
+		        (uint64_t)sizeof(header) + header.storedSize <= (uint64_t)size;
+	}
+	if (valid) {
+		const unsigned char* stored = data + sizeof(header);
+		if (header.flags & SNAPSHOT_FLAG_DEFLATE) {
+			int rawSize = 0;
+			unsigned char* raw = DecompressData(stored, (int)header.storedSize, &rawSize);
+			valid = raw != nullptr && rawSize == (int)header.rawSize;
+			if (valid) payload.assign(raw, raw + rawSize);
+			if (raw) MemFree(raw);
+		} else {
+			payload.assign(stored, stored + header.storedSize);
+		}
+		valid = valid && SaveChecksum(payload.data(), payload.size()) == header.checksum;
+	}
+	UnloadFileData(data);
+
+	if (!valid) {
+		TraceLog(LOG_WARNING, "SNAPSHOT: [%s] 存档无效或已损坏", path.c_str());
+		payload.clear();
+	}
+	return valid;
+}
+
+/// 是否还有存档在后台写入
+bool IsSnapshotSaving() {
+	return snapshotPending.load() > 0;
+}
+
+/// 等待所有后台存档写完（退出前调用）
+void FlushSnapshots() {
+	snapshotWriter.Flush();
+}
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,204 @@
+#ifndef TWEEN_H
+#define TWEEN_H
+
+#include "raylib.h"
+#include "input.h"
+#include "framemem.h"
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <cmath>
+
+// ==================== 缓动曲线 ====================
+
+typedef float (*EaseFunc)(float t); // t 取 [0, 1]
+
+float EaseLinear(float t) { return t; }
+float EaseInQuad(float t) { return t * t; }
+float EaseOutQuad(float t) { return t * (2.0f - t); }
+float EaseInOutQuad(float t) { return t < 0.5f ? 2.0f * t * t : -1.0f + (4.0f - 2.0f * t) * t; }
+float EaseInCubic(float t) { return t * t * t; }
+float EaseOutCubic(float t) { float u = t - 1.0f; return u * u * u + 1.0f; }
+float EaseInOutCubic(float t) {
+	return t < 0.5f ? 4.0f * t * t * t : (t - 1.0f) * (2.0f * t - 2.0f) * (2.0f * t - 2.0f) + 1.0f;
+}
+float EaseOutBack(float t) {
+	const float c1 = 1.70158f;
+	const float c3 = c1 + 1.0f;
+	float u = t - 1.0f;
+	return 1.0f + c3 * u * u * u + c1 * u * u;
+}
+
+// ==================== 补间调度器 ====================
+//
+// 所有补间共用游戏时钟（每帧 UpdateTweens 时读取一次 GetInputTime），
+// 效果的快慢只取决于经过的秒数，与帧率无关。
+// 尚未开始的补间按开始时间排队，已结束的立即移除，没有补间时每帧几乎没有开销。
+
+typedef int TweenId;
+
+struct Tween {
+	TweenId id;
+	const void* owner;   // 所属对象，销毁时用 KillTweensOf 一起清除
+	double start;        // 开始时刻（时钟秒）
+	float duration;
+	float from;
+	float to;
+	EaseFunc ease;
+	std::function<void(float)> apply;  // 每帧写入当前值
+	std::function<void()> onComplete;
+	bool killed;
+};
+
+static std::vector<Tween> tweenPending; // 按 start 升序
+static std::vector<Tween> tweenActive;
+static double tweenClock = -1.0;
+static TweenId tweenNextId = 1;
+
+/// 补间时钟的当前时刻（同一帧内不变）
+double GetTweenTime() {
+	if (tweenClock < 0) tweenClock = GetInputTime();
+	return tweenClock;
+}
+
+/// 开始一个补间：delay 秒后在 duration 秒内把 from 变到 to，返回可用于取消的编号
+TweenId StartTween(float from, float to, float duration, std::function<void(float)> apply,
+                   EaseFunc ease = EaseLinear, float delay = 0.0f, const void* owner = nullptr,
+                   std::function<void()> onComplete = nullptr) {
+	AllowFrameAllocations(); // 补间由一次性事件触发
+	Tween tween;
+	TweenId id = tweenNextId++;
+	tween.id = id;
+	tween.owner = owner;
+	tween.start = GetTweenTime() + (delay > 0 ? delay : 0);
+	tween.duration = duration > 0 ? duration : 0;
+	tween.from = from;
+	tween.to = to;
+	tween.ease = ease ? ease : EaseLinear;
+	tween.apply = std::move(apply);
+	tween.onComplete = std::move(onComplete);
+	tween.killed = false;
+
+	auto pos = std::upper_bound(tweenPending.begin(), tweenPending.end(), tween.start,
+	[](double start, const Tween& other) {
+		return start < other.start;
+	});
+	tweenPending.insert(pos, std::move(tween));
+	return id;
+}
+
+/// 延迟调用（时长为 0 的补间）
+TweenId StartTimer(float delay, std::function<void()> callback, const void* owner = nullptr) {
+	return StartTween(0, 0, 0, nullptr, EaseLinear, delay, owner, std::move(callback));
+}
+
+/// 每帧调用一次：推进时钟并更新所有进行中的补间
+void UpdateTweens() {
+	tweenClock = GetInputTime();
+
+	// 到点的补间转入进行中（回调里新建的补间下一帧才开始）
+	size_t due = 0;
+	while (due < tweenPending.size() && tweenPending[due].start <= tweenClock) ++due;
+	if (due > 0) {
+		for (size_t i = 0; i < due; ++i) {
+			tweenActive.push_back(std::move(tweenPending[i]));
+		}
+		tweenPending.erase(tweenPending.begin(), tweenPending.begin() + due);
+	}
+
+	size_t count = tweenActive.size();
+	for (size_t i = 0; i < count; ++i) {
+		if (tweenActive[i].killed) continue;
+
+		float t = 1.0f;
+		if (tweenActive[i].duration > 0) {
+			t = (float)((tweenClock - tweenActive[i].start) / tweenActive[i].duration);
+			t = t < 0 ? 0 : (t > 1 ? 1 : t);
+		}
+		if (tweenActive[i].apply) {
+			const Tween& tween = tweenActive[i];
+			tween.apply(tween.from + (tween.to - tween.from) * tween.ease(t));
+		}
+		if (t >= 1.0f && !tweenActive[i].killed) {
+			tweenActive[i].killed = true;
+			std::function<void()> done = std::move(tweenActive[i].onComplete);
+			if (done) done();
+		}
+	}
+
+	tweenActive.erase(std::remove_if(tweenActive.begin(), tweenActive.end(),
+	[](const Tween& tween) {
+		return tween.killed;
+	}), tweenActive.end());
+}
+
+bool IsTweenActive(TweenId id) {
+	for (const auto& tween : tweenActive) {
+		if (tween.id == id) return !tween.killed;
+	}
+	for (const auto& tween : tweenPending) {
+		if (tween.id == id) return !tween.killed;
+	}
+	return false;
+}
+
+/// 取消补间（不调用 onComplete）
+void KillTween(TweenId id) {
+	for (auto& tween : tweenActive) {
+		if (tween.id == id) tween.killed = true;
+	}
+	tweenPending.erase(std::remove_if(tweenPending.begin(), tweenPending.end(),
+	[id](const Tween& tween) {
+		return tween.id == id;
+	}), tweenPending.end());
+}
+
+/// 取消某个对象的全部补间（对象析构时调用）
+void KillTweensOf(const void* owner) {
+	if (!owner) return;
+	for (auto& tween : tweenActive) {
+		if (tween.owner == owner) tween.killed = true;
+	}
+	tweenPending.erase(std::remove_if(tweenPending.begin(), tweenPending.end(),
+	[owner](const Tween& tween) {
+		return tween.owner == owner;
+	}), tweenPending.end());
+}
+
+// ==================== 时间线 ====================
+
+/// 按顺序排布补间：每一步在上一步结束后开始，所有步骤在创建时一次排好，没有累积误差
+class Timeline {
+private:
+	const void* owner;
+	float cursor; // 下一步的开始时刻（相对创建时）
+	std::vector<TweenId> ids;
+
+public:
+	explicit Timeline(const void* timelineOwner = nullptr) : owner(timelineOwner), cursor(0) {}
+
+	Timeline& Then(float duration, float from, float to, std::function<void(float)> apply, EaseFunc ease = EaseLinear) {
+		ids.push_back(StartTween(from, to, duration, std::move(apply), ease, cursor, owner));
+		cursor += duration;
+		return *this;
+	}
+
+	Timeline& Wait(float seconds) {
+		cursor += seconds;
+		return *this;
+	}
+
+	Timeline& Call(std::function<void()> callback) {
+		ids.push_back(StartTimer(cursor, std::move(callback), owner));
+		return *this;
+	}
+
+	float Duration() const { return cursor; }
+
+	void Kill() {
+		for (TweenId id : ids) KillTween(id);
+		ids.clear();
+	}
+};
+
+#endif // TWEEN_H
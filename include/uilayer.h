@@ -0,0 +1,170 @@
+#ifndef UILAYER_H
+#define UILAYER_H
+
+#include "raylib.h"
+#include "rlgl.h"
+#include "profiler.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// ==================== 保留模式 UI 层 ====================
+//
+// 每个面板把内容画进自己的 RenderTexture，之后每帧只把纹理贴到屏幕上（一个四边形）。
+// 面板记住上次绘制时的内容键（由调用方把决定外观的数据混合成一个整数），
+// 键或尺寸变化、或被 MarkUiPanelDirty 标脏时才重画，否则跳过全部绘制调用和字体查找。
+//
+// 用法（在 BeginDrawing 之后、世界层之外）：
+//   if (BeginUiPanel(panel, width, height, key)) {
+//       ...以面板左上角为原点绘制...
+//       EndUiPanel();
+//   }
+//   DrawUiPanel(panel, {x, y});
+//
+// 面板纹理里存的是预乘 alpha 的颜色：绘制时 alpha 通道单独累加，贴到屏幕时按预乘混合，
+// 半透明的底框和直接画到屏幕上的结果一致。
+//
+// 每帧开头调用 UpdateUiLayer()，GetUiPanelRedraws() 返回上一帧重画的面板数。
+
+static const uint64_t UI_KEY_SEED = 14695981039346656037ull;
+
+struct UiPanelSlot {
+	RenderTexture2D target = {0};
+	uint64_t key = 0;
+	bool dirty = true;
+	bool used = false;
+};
+
+static std::vector<UiPanelSlot> uiPanels;
+static std::vector<int> uiFreePanels;
+static int uiActivePanel = -1;  // 正在重画的面板
+static int uiRedrawsFrame = 0;  // 本帧到目前为止的重画次数
+static int uiRedrawsLast = 0;   // 上一帧的重画次数
+
+/// 把一段数据混入内容键（FNV-1a）
+uint64_t MixUiKey(uint64_t key, const void* data, size_t size) {
+	const unsigned char* bytes = (const unsigned char*)data;
+	for (size_t i = 0; i < size; ++i) {
+		key ^= bytes[i];
+		key *= 1099511628211ull;
+	}
+	return key;
+}
+
+uint64_t MixUiKey(uint64_t key, int64_t value) {
+	return MixUiKey(key, &value, sizeof(value));
+}
+
+/// 文本连同长度一起混入，相邻的两段文本不会因为拼接相同而撞键
+uint64_t MixUiKey(uint64_t key, const char* text, size_t length) {
+	return MixUiKey(MixUiKey(key, (const void*)text, length), (int64_t)length);
+}
+
+uint64_t MixUiKey(uint64_t key, const std::string& text) {
+	return MixUiKey(key, text.data(), text.size());
+}
+
+uint64_t MixUiKey(uint64_t key, const char* text) {
+	return text ? MixUiKey(key, text, strlen(text)) : MixUiKey(key, (int64_t)-1);
+}
+
+/// 创建一个面板，返回句柄（纹理在第一次 BeginUiPanel 时按需创建）
+int CreateUiPanel() {
+	int panel;
+	if (!uiFreePanels.empty()) {
+		panel = uiFreePanels.back();
+		uiFreePanels.pop_back();
+	} else {
+		panel = (int)uiPanels.size();
+		uiPanels.emplace_back();
+	}
+	uiPanels[panel] = UiPanelSlot();
+	uiPanels[panel].used = true;
+	return panel;
+}
+
+/// 释放面板和它的纹理（UnloadUiLayer 之后调用也安全）
+void ReleaseUiPanel(int panel) {
+	if (panel < 0 || panel >= (int)uiPanels.size() || !uiPanels[panel].used) return;
+	if (uiPanels[panel].target.id != 0) UnloadRenderTexture(uiPanels[panel].target);
+	uiPanels[panel] = UiPanelSlot();
+	uiFreePanels.push_back(panel);
+}
+
+/// 内容键以外的原因（例如字体或贴图替换）需要重画时调用
+void MarkUiPanelDirty(int panel) {
+	if (panel >= 0 && panel < (int)uiPanels.size()) uiPanels[panel].dirty = true;
+}
+
+void MarkAllUiPanelsDirty() {
+	for (auto& slot : uiPanels) slot.dirty = true;
+}
+
+/// 面板需要重画时开始绘制到面板纹理并返回 true（之后必须调用 EndUiPanel），否则返回 false
+bool BeginUiPanel(int panel, int width, int height, uint64_t key) {
+	if (panel < 0 || panel >= (int)uiPanels.size() || !uiPanels[panel].used || uiActivePanel >= 0) return false;
+	if (width < 1) width = 1;
+	if (height < 1) height = 1;
+	UiPanelSlot& slot = uiPanels[panel];
+	bool resized = slot.target.id == 0 || slot.target.texture.width != width || slot.target.texture.height != height;
+	if (!resized && !slot.dirty && slot.key == key) return false;
+
+	if (resized) {
+		if (slot.target.id != 0) UnloadRenderTexture(slot.target);
+		slot.target = LoadRenderTexture(width, height);
+	}
+	slot.key = key;
+	slot.dirty = false;
+	uiActivePanel = panel;
+	++uiRedrawsFrame;
+
+	PROFILE_BEGIN("ui panel redraw");
+	BeginTextureMode(slot.target);
+	ClearBackground(BLANK);
+	// 颜色按 alpha 混合，alpha 通道累加覆盖率，得到预乘 alpha 的纹理
+	rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE, RL_ONE_MINUS_SRC_ALPHA, RL_FUNC_ADD, RL_FUNC_ADD);
+	BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+	return true;
+}
+
+void EndUiPanel() {
+	if (uiActivePanel < 0) return;
+	EndBlendMode();
+	EndTextureMode();
+	PROFILE_END();
+	uiActivePanel = -1;
+}
+
+/// 把面板贴到屏幕上，alpha 为整体不透明度
+void DrawUiPanel(int panel, Vector2 position, float alpha = 1.0f) {
+	if (panel < 0 || panel >= (int)uiPanels.size() || uiPanels[panel].target.id == 0) return;
+	const Texture2D& texture = uiPanels[panel].target.texture;
+	// 预乘 alpha：色调的 rgb 也要乘上不透明度
+	unsigned char a = (unsigned char)(alpha <= 0.0f ? 0 : alpha >= 1.0f ? 255 : alpha * 255.0f);
+	// RenderTexture 的纹理上下颠倒；取整到像素，避免文字被采样模糊
+	Rectangle source = {0, 0, (float)texture.width, -(float)texture.height};
+	BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+	DrawTextureRec(texture, source, {std::floor(position.x), std::floor(position.y)}, {a, a, a, a});
+	EndBlendMode();
+}
+
+/// 每帧开头调用一次，结算上一帧的重画次数
+void UpdateUiLayer() {
+	uiRedrawsLast = uiRedrawsFrame;
+	uiRedrawsFrame = 0;
+}
+
+int GetUiPanelRedraws() { return uiRedrawsLast; }
+
+/// 卸载所有面板纹理（CloseWindow 之前调用）；句柄仍然有效，下次使用时重建
+void UnloadUiLayer() {
+	for (auto& slot : uiPanels) {
+		if (slot.target.id != 0) UnloadRenderTexture(slot.target);
+		slot.target = {0};
+		slot.dirty = true;
+	}
+}
+
+#endif // UILAYER_H
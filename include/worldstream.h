@@ -0,0 +1,409 @@
+#ifndef WORLDSTREAM_H
+#define WORLDSTREAM_H
+
+#include "raylib.h"
+#include "assetpack.h"
+#include "asset.h"
+#include "character.h"
+#include "interaction.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <sstream>
+#include <cmath>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// ==================== 区域文件格式 ====================
+//
+// 世界按 regionSize 划分为方格，格子 (x, y) 对应文件 <目录>/<x>_<y>.region，
+// 坐标均为世界坐标，没有文件的格子视为空地。
+//
+//   # 注释
+//   box <x> <y> <宽> <高> <是否实心 0/1> [名称]
+//   image <id> <贴图路径> <x> <y> <缩放> [碰撞箱 x y 宽 高 是否实心]
+//   interact <x> <y> <距离> <对话编号> [事件名]
+//   trigger <x> <y> <宽> <高> <对话编号> [事件名]
+//
+// 有名字的非实心 box 同时登记为触发区，事件名就是它的名字。
+
+/// 区域内的一个图片物体（碰撞箱为物体局部坐标，宽为 0 表示没有）
+struct RegionObjectDesc {
+	std::string id;
+	std::string texturePath;
+	Vector2 position;
+	float scale;
+	Rectangle collision;
+	bool solid;
+};
+
+/// 工作线程解析出的区域内容
+struct RegionData {
+	std::vector<CollisionBox> boxes;
+	std::vector<RegionObjectDesc> objects;
+	std::vector<Interactable> interactables;
+	std::vector<TriggerVolume> triggers;
+};
+
+/// 解析区域文件（线程安全，只做读取和文本解析）
+bool ParseRegionFile(const std::string& path, RegionData& data) {
+	std::string text;
+	PackData packed = assetPack.Load(path);
+	if (packed.data) {
+		text.assign((const char*)packed.data, packed.size);
+		UnloadPackData(packed);
+	} else {
+		int size = 0;
+		unsigned char* raw = LoadFileData(path.c_str(), &size);
+		if (!raw) return false;
+		text.assign((const char*)raw, size);
+		UnloadFileData(raw);
+	}
+
+	std::istringstream lines(text);
+	std::string line;
+	int lineNumber = 0;
+	// 格式不对的行整行跳过，不把半截数据放进世界
+	auto skip = [&](const char* kind) {
+		TraceLog(LOG_WARNING, "WORLD: [%s] 第 %d 行的 %s 格式不对，已跳过", path.c_str(), lineNumber, kind);
+	};
+	while (std::getline(lines, line)) {
+		++lineNumber;
+		if (!line.empty() && line.back() == '\r') line.pop_back();
+		std::istringstream in(line);
+		std::string kind;
+		if (!(in >> kind) || kind[0] == '#') continue;
+
+		if (kind == "box") {
+			CollisionBox box{};
+			int solid = 1;
+			if (!(in >> box.rect.x >> box.rect.y >> box.rect.width >> box.rect.height >> solid)) {
+				skip("box");
+				continue;
+			}
+			std::getline(in >> std::ws, box.name);
+			box.color = solid ? DARKGRAY : LIGHTGRAY;
+			box.isSolid = solid != 0;
+			data.boxes.push_back(box);
+		} else if (kind == "image") {
+			RegionObjectDesc object{};
+			int solid = 1;
+			object.scale = 1.0f;
+			if (!(in >> object.id >> object.texturePath >> object.position.x >> object.position.y >> object.scale)) {
+				skip("image");
+				continue;
+			}
+			// 碰撞箱可以省略，但写了就要写全
+			if (!(in >> std::ws).eof() &&
+				!(in >> object.collision.x >> object.collision.y >> object.collision.width >> object.collision.height >> solid)) {
+				skip("image");
+				continue;
+			}
+			object.solid = solid != 0;
+			data.objects.push_back(object);
+		} else if (kind == "interact") {
+			Interactable interactable{};
+			if (!(in >> interactable.position.x >> interactable.position.y >> interactable.reach >> interactable.dialogId)) {
+				skip("interact");
+				continue;
+			}
+			std::getline(in >> std::ws, interactable.event);
+			data.interactables.push_back(interactable);
+		} else if (kind == "trigger") {
+			TriggerVolume trigger{};
+			if (!(in >> trigger.rect.x >> trigger.rect.y >> trigger.rect.width >> trigger.rect.height >> trigger.dialogId)) {
+				skip("trigger");
+				continue;
+			}
+			std::getline(in >> std::ws, trigger.event);
+			data.triggers.push_back(trigger);
+		} else {
+			TraceLog(LOG_WARNING, "WORLD: [%s] 第 %d 行: 未知的记录类型 %s", path.c_str(), lineNumber, kind.c_str());
+		}
+	}
+	return true;
+}
+
+// ==================== 世界流式加载 ====================
+
+enum class RegionState {
+	LOADING, // 已排队，等待工作线程解析
+	LOADED   // 内容已加入 GameObjectSystem / CollisionSystem
+};
+
+class WorldStreamer {
+private:
+	struct Region {
+		int owner; // 碰撞箱归属编号，同时用来识别过期的加载结果
+		RegionState state;
+		std::vector<std::string> objectIds;
+	};
+
+	struct RegionJob {
+		int64_t key;
+		int owner;
+		std::string path;
+		RegionData data;
+	};
+
+	std::string directory;
+	float regionSize;
+	float loadMargin;   // 视野外扩多少开始加载
+	float unloadMargin; // 视野外扩多少之外才卸载（大于 loadMargin，避免在边界反复加载）
+	GameObjectSystem& objects;
+	CollisionSystem& collisions;
+	InteractionSystem* interactions; // 可选
+
+	std::unordered_map<int64_t, Region> regions; // 只保存加载中和已加载的区域
+	int nextOwner;
+
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable parsed; // 工作线程每完成一个区域通知一次
+	std::deque<RegionJob> requests;
+	std::deque<RegionJob> results;
+	std::deque<RegionJob> ready; // 主线程取出的结果，复用以免每帧分配
+	std::vector<std::thread> workers;
+	bool stopping;
+
+	static int64_t Key(int x, int y) { return (int64_t)(((uint64_t)(uint32_t)x << 32) | (uint32_t)y); }
+	static int KeyX(int64_t key) { return (int32_t)((uint64_t)key >> 32); }
+	static int KeyY(int64_t key) { return (int32_t)(uint32_t)key; }
+
+	void WorkerLoop();
+	void Instantiate(Region& region, RegionData& data);
+	void Unload(int64_t key, Region& region);
+	void AcceptResults();
+
+public:
+	WorldStreamer(const std::string& dir, float size, GameObjectSystem& objectSystem, CollisionSystem& collisionSystem);
+	~WorldStreamer() { Stop(); }
+
+	WorldStreamer(const WorldStreamer&) = delete;
+	WorldStreamer& operator=(const WorldStreamer&) = delete;
+
+	void SetMargins(float load, float unload);
+	// 区域里的可交互点和触发区登记到这里（不设置时忽略）
+	void SetInteractionSystem(InteractionSystem* system) { interactions = system; }
+	void Start(int workerCount = 1);
+	void Stop(); // 结束工作线程并卸载所有区域
+
+	// 每帧在主线程调用：只检查视野附近的格子和已加载的区域，与世界总大小无关
+	void Update(const Rectangle& view);
+
+	// 等待所有排队中的区域加载完成（录制/回放时调用，使区域出现的 tick 可复现）
+	void FinishPending();
+
+	int GetLoadedRegionCount() const;
+	int GetPendingRegionCount() const;
+};
+
+// ==================== WorldStreamer 实现 ====================
+
+WorldStreamer::WorldStreamer(const std::string& dir, float size, GameObjectSystem& objectSystem, CollisionSystem& collisionSystem)
+: directory(dir), regionSize(size > 1.0f ? size : 1.0f), loadMargin(size * 0.5f), unloadMargin(size),
+objects(objectSystem), collisions(collisionSystem), interactions(nullptr), nextOwner(1), stopping(false) {}
+
+void WorldStreamer::SetMargins(float load, float unload) {
+	loadMargin = load;
+	unloadMargin = unload > load ? unload : load;
+}
+
+void WorldStreamer::Start(int workerCount) {
+	if (!workers.empty()) return;
+	stopping = false;
+	if (workerCount < 1) workerCount = 1;
+	for (int i = 0; i < workerCount; ++i) {
+		workers.emplace_back(&WorldStreamer::WorkerLoop, this);
+	}
+}
+
+void WorldStreamer::Stop() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+		requests.clear();
+	}
+	wake.notify_all();
+	for (auto& worker : workers) {
+		worker.join();
+	}
+	workers.clear();
+	results.clear();
+
+	for (auto& [key, region] : regions) {
+		if (region.state == RegionState::LOADED) Unload(key, region);
+	}
+	regions.clear();
+}
+
+void WorldStreamer::WorkerLoop() {
+	SetProfileThreadName("world streamer");
+	while (true) {
+		RegionJob job;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [this] { return stopping || !requests.empty(); });
+			if (stopping) return;
+			job = std::move(requests.front());
+			requests.pop_front();
+		}
+
+		{
+			PROFILE_SCOPE("region parse");
+			ParseRegionFile(job.path, job.data); // 文件不存在就是空区域
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			results.push_back(std::move(job));
+		}
+		parsed.notify_all();
+	}
+}
+
+void WorldStreamer::Instantiate(Region& region, RegionData& data) {
+	AllowFrameAllocations(); // 区域进出视野的帧会创建/销毁物体
+	for (const auto& box : data.boxes) {
+		collisions.AddCollisionBox(box.rect, box.color, box.isSolid, box.name, region.owner);
+		if (interactions && !box.isSolid && !box.name.empty()) {
+			interactions->AddTrigger(box.rect, 0, box.name, region.owner);
+		}
+	}
+	if (interactions) {
+		for (const auto& interactable : data.interactables) {
+			interactions->AddInteractable(interactable.position, interactable.reach, interactable.dialogId, interactable.event, region.owner);
+		}
+		for (const auto& trigger : data.triggers) {
+			interactions->AddTrigger(trigger.rect, trigger.dialogId, trigger.event, region.owner);
+		}
+	}
+	for (const auto& desc : data.objects) {
+		// 贴图走异步加载器，就绪前显示占位纹理
+		auto object = std::make_shared<ImageObject>(desc.texturePath, desc.id);
+		object->SetPosition(desc.position);
+		object->SetScale(desc.scale);
+		if (desc.collision.width > 0 && desc.collision.height > 0) {
+			object->AddCollisionComponent(desc.collision, desc.solid ? RED : YELLOW, desc.solid, desc.id + "_collision");
+		}
+		objects.AddObject(desc.id, object);
+		region.objectIds.push_back(desc.id);
+	}
+	region.state = RegionState::LOADED;
+}
+
+void WorldStreamer::Unload(int64_t key, Region& region) {
+	AllowFrameAllocations();
+	for (const auto& id : region.objectIds) {
+		objects.RemoveObject(id);
+	}
+	region.objectIds.clear();
+	collisions.RemoveOwner(region.owner);
+	if (interactions) interactions->RemoveOwner(region.owner);
+	TraceLog(LOG_DEBUG, "WORLD: 卸载区域 (%d, %d)", KeyX(key), KeyY(key));
+}
+
+void WorldStreamer::AcceptResults() {
+	// 区域已被取消的结果直接丢弃
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		ready.swap(results);
+	}
+	for (auto& job : ready) {
+		auto it = regions.find(job.key);
+		if (it != regions.end() && it->second.owner == job.owner && it->second.state == RegionState::LOADING) {
+			Instantiate(it->second, job.data);
+		}
+	}
+	ready.clear();
+}
+
+void WorldStreamer::FinishPending() {
+	AcceptResults();
+	while (!workers.empty() && GetPendingRegionCount() > 0) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			parsed.wait(lock, [this] { return !results.empty(); });
+		}
+		AcceptResults();
+	}
+}
+
+void WorldStreamer::Update(const Rectangle& view) {
+	PROFILE_SCOPE("world stream");
+	// 1. 接收工作线程的结果
+	AcceptResults();
+
+	// 2. 卸载离开外圈的区域
+	Rectangle keep = {view.x - unloadMargin, view.y - unloadMargin,
+	                  view.width + unloadMargin * 2, view.height + unloadMargin * 2};
+	bool released = false;
+	for (auto it = regions.begin(); it != regions.end();) {
+		Rectangle cell = {KeyX(it->first) * regionSize, KeyY(it->first) * regionSize, regionSize, regionSize};
+		if (CheckCollisionRecs(cell, keep)) {
+			++it;
+			continue;
+		}
+		if (it->second.state == RegionState::LOADED) {
+			Unload(it->first, it->second);
+			released = true;
+		} else {
+			// 还在排队的请求直接撤销
+			std::lock_guard<std::mutex> lock(mutex);
+			int owner = it->second.owner;
+			requests.erase(std::remove_if(requests.begin(), requests.end(),
+			[owner](const RegionJob& job) {
+				return job.owner == owner;
+			}), requests.end());
+		}
+		it = regions.erase(it);
+	}
+	if (released) {
+		ReleaseUnusedTextures();
+	}
+
+	// 3. 请求进入内圈的区域
+	int minX = (int)std::floor((view.x - loadMargin) / regionSize);
+	int minY = (int)std::floor((view.y - loadMargin) / regionSize);
+	int maxX = (int)std::floor((view.x + view.width + loadMargin) / regionSize);
+	int maxY = (int)std::floor((view.y + view.height + loadMargin) / regionSize);
+	bool queued = false;
+	for (int y = minY; y <= maxY; ++y) {
+		for (int x = minX; x <= maxX; ++x) {
+			int64_t key = Key(x, y);
+			if (regions.count(key)) continue;
+
+			Region& region = regions[key];
+			region.owner = nextOwner++;
+			region.state = RegionState::LOADING;
+
+			RegionJob job;
+			job.key = key;
+			job.owner = region.owner;
+			job.path = directory + "/" + std::to_string(x) + "_" + std::to_string(y) + ".region";
+			std::lock_guard<std::mutex> lock(mutex);
+			requests.push_back(std::move(job));
+			queued = true;
+		}
+	}
+	if (queued) {
+		if (workers.empty()) Start();
+		wake.notify_all();
+	}
+}
+
+int WorldStreamer::GetLoadedRegionCount() const {
+	int loaded = 0;
+	for (const auto& [key, region] : regions) {
+		if (region.state == RegionState::LOADED) ++loaded;
+	}
+	return loaded;
+}
+
+int WorldStreamer::GetPendingRegionCount() const {
+	return (int)regions.size() - GetLoadedRegionCount();
+}
+
+#endif // WORLDSTREAM_H
@@ -1,18 +1,27 @@
 #include "raylib.h"
 #include "include/character.h"
+#include "include/scene.h"
 #include "include/achievement.h"
+#include "include/uilayer.h"
 
-int main() {
+int main(int argc, char** argv) {
 	const int screenWidth = 800;
 	const int screenHeight = 450;
 	InitWindow(screenWidth, screenHeight, "2D角色移动系统");
+	// 挂载资源包（不存在时读取 resource/ 下的散文件）
+	InitAssetPack("assets.pak");
 	InitFontSystem("C:\\Windows\\Fonts\\simhei.ttf");
+	InitAssetLoader();
 
 	AchievementSystem achievementSys;
 	achievementSys.Init();
 
 	achievementSys.AddAchievement({"first", "踩踩背", "第一次踩背", false, ACH_COMMON});
 	achievementSys.AddAchievement({"rare", "超级踩背王", "踩100+个人的背", false, ACH_RARE});
+	// 踩背次数：1 次解锁 first，100 次解锁 rare
+	int backStepStat = achievementSys.RegisterStat("back_step");
+	achievementSys.LinkStat("first", backStepStat, 1);
+	achievementSys.LinkStat("rare", backStepStat, 100);
 	achievementSys.Read();
 
 	// 创建系统对象
@@ -29,51 +38,86 @@ int main() {
 	// 设置精灵表布局（如果素材布局不同可以修改这里）
 	// player.SetSpriteLayout(0, 1, 2, 3); // 默认就是这样的布局
 
-	// 添加碰撞箱
-	collisionSystem.AddCollisionBox({200, 200, 100, 50}, BLUE, true, "箱子1");
-	collisionSystem.AddCollisionBox({500, 300, 80, 120}, GREEN, true, "箱子2");
-	collisionSystem.AddCollisionBox({800, 150, 150, 40}, YELLOW, true, "长平台");
-	collisionSystem.AddCollisionBox({300, 500, 60, 60}, ORANGE, true, "方块");
-	collisionSystem.AddCollisionBox({700, 600, 120, 30}, PURPLE, true, "平台");
-	collisionSystem.AddCollisionBox({400, 400, 70, 70}, GRAY, false, "可穿过");
+	// 碰撞箱和出生点来自场景文件：优先加载离线编译的二进制，没有时现场编译文本
+	SceneInfo scene;
+	if (!LoadScene("scene/main.sceneb", &collisionSystem, nullptr, &scene)) {
+		LoadSceneSource("scene/main.scene", &collisionSystem, nullptr, &scene);
+	}
+	if (scene.hasSpawn) {
+		player.SetPosition(scene.spawn);
+	}
 
 	Vector2 worldSize = {screenWidth * 3, screenHeight * 3};
 	SetTargetFPS(60);
+	// 录制/回放输入：--record <文件> 或 --replay <文件>
+	InitInput(argc, argv);
+	// --alloc-guard：预热后报告稳态帧里的堆分配
+	InitAllocationGuard(argc, argv);
+
+	// 左上角的说明和状态文字
+	int hudPanel = CreateUiPanel();
+
+	while (!WindowShouldClose() && BeginInputFrame()) {
+		PROFILE_FRAME();
+		ResetFrameArena();
+
+		// 在预算内上传后台解码好的纹理
+		UpdateAssetLoader();
+		// 推进补间和计时器（按秒计时，与帧率无关）
+		UpdateTweens();
+		UpdateParticles();
+		UpdateUiLayer();
+		
 
-	while (!WindowShouldClose()) {
-
-		if (IsKeyPressed(KEY_ONE)) {
-			achievementSys.Unlock("first");
+		PROFILE_BEGIN("input");
+		if (InputPressed(KEY_ONE)) {
+			achievementSys.PostStat(backStepStat);
 		}
-		if (IsKeyPressed(KEY_TWO)) {
+		if (InputPressed(KEY_TWO)) {
 			achievementSys.Unlock("rare");
 		}
+		// 分析器：F3 显示耗时叠加层，F4 导出 Chrome trace（调试按键直接读 raylib，不参与录制）
+		if (IsKeyPressed(KEY_F3)) {
+			ToggleProfilerOverlay();
+		}
+		if (IsKeyPressed(KEY_F4)) {
+			ExportProfilerTrace("save/profile.json");
+		}
+		PROFILE_END();
 
+		PROFILE_BEGIN("update");
 		achievementSys.Update();
 
-		float deltaTime = GetFrameTime();
+		float deltaTime = GetInputDeltaTime();
 
 		// 保存旧位置用于碰撞检测
 		Vector2 oldPosition = player.GetPosition();
-		Rectangle oldCollision = player.GetCollisionBox();
 
 		// 处理输入
 		player.HandleInput();
 		player.Update(deltaTime);
+		// 统一推进本帧登记过的角色动画
+		UpdateAnimations();
+		PROFILE_END();
 
 		// 碰撞检测
+		PROFILE_BEGIN("collision");
 		if (collisionSystem.CheckCollision(player.GetCollisionBox())) {
-			player.ResolveCollision(oldPosition, oldCollision);
+			player.ResolveCollision(oldPosition);
 		}
 
 		// 边界检查
 		player.CheckWorldBounds(worldSize);
+		PROFILE_END();
 
 		// 更新相机
+		PROFILE_BEGIN("camera");
 		cameraSystem.Update(player.GetPosition());
+		PROFILE_END();
 
 		// 绘制
-		BeginDrawing();
+		PROFILE_BEGIN("world draw");
+		BeginWorldRender();
 
 		ClearBackground(BLACK);
 
@@ -94,36 +138,62 @@ int main() {
 		player.Draw();
 
 		// 调试显示碰撞箱
-		if (IsKeyDown(KEY_C)) {
+		if (InputDown(KEY_C)) {
 			player.DrawCollisionDebug();
 		}
 
 		cameraSystem.EndMode();
+		EndWorldRender();
+		PROFILE_END();
 
-		// 绘制UI
-		DrawTextUTF("使用WASD或方向键移动", Vector2{10, 10}, 20, 1, DARKGRAY);
-		DrawTextUTF("按C键显示碰撞箱", Vector2{10, 40}, 20, 1, DARKGRAY);
-
-		// 显示角色状态
-		std::string statusText = "状态: " +
-		                         CharacterUtils::StateToString(player.GetState()) + " - " +
-		                         CharacterUtils::DirectionToString(player.GetDirection());
-		DrawTextUTF(statusText, Vector2{10, 70}, 20, 1, DARKBLUE);
+		// 世界层拉伸到窗口，UI 按原生分辨率画在上面
+		BeginDrawing();
+		DrawWorldRender();
 
-		if (!textureLoaded) {
-			DrawTextUTF("无法加载角色纹理，使用替代图形", Vector2{10, 100}, 20, 1, ORANGE);
+		// 绘制UI
+		PROFILE_BEGIN("ui draw");
+		// 说明文字和角色状态缓存在面板里，状态变化时才重画
+		const char* statusText = FrameFormat("状态: %s - %s",
+		                                      CharacterUtils::StateToString(player.GetState()),
+		                                      CharacterUtils::DirectionToString(player.GetDirection()));
+		if (BeginUiPanel(hudPanel, 400, 120, MixUiKey(MixUiKey(UI_KEY_SEED, statusText), (int64_t)textureLoaded))) {
+			DrawTextUTF("使用WASD或方向键移动", Vector2{0, 0}, 20, 1, DARKGRAY);
+			DrawTextUTF("按C键显示碰撞箱", Vector2{0, 30}, 20, 1, DARKGRAY);
+			DrawTextUTF(statusText, Vector2{0, 60}, 20, 1, DARKBLUE);
+			if (!textureLoaded) {
+				DrawTextUTF("无法加载角色纹理，使用替代图形", Vector2{0, 90}, 20, 1, ORANGE);
+			}
+			EndUiPanel();
 		}
+		DrawUiPanel(hudPanel, {10, 10});
 
 		DrawFPS(screenWidth - 100, 10);
+		if (IsProfilerOverlayVisible()) {
+			DrawText(TextFormat("ui redraws: %d", GetUiPanelRedraws()), screenWidth - 100, 35, 10, DARKGRAY);
+		}
 		
 		achievementSys.Draw();
+		DrawParticles(PARTICLE_SCREEN);
 		
+		DrawProfilerOverlay();
+		PROFILE_END();
+
+		PROFILE_BEGIN("EndDrawing");
 		EndDrawing();
+		PROFILE_END();
+
+		// 按帧耗时调整世界层的渲染比例
+		UpdateRenderScale();
 	}
 
+	UnloadInput();
 	UnloadFontSystem();
 	achievementSys.Save();
 	player.UnloadResources();
+	UnloadAssetLoader();
+	UnloadAssetPack();
+	UnloadUiLayer();
+	UnloadRenderScale();
 	CloseWindow();
 
 	return 0;
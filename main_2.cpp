@@ -1,15 +1,22 @@
 #include "raylib.h"
 #include "include/dialog.h"
 #include "include/character.h"
+#include "include/scene.h"
 #include "include/achievement.h"
+#include "include/uilayer.h"
 #include "include/Circle.h"
-int main() {
+#include "include/rewind.h"
+#include "include/interaction.h"
+int main(int argc, char** argv) {
 	const int screenWidth = 800;
 	const int screenHeight = 600;
 	int canwalk = 1;
 
 	InitWindow(screenWidth, screenHeight, "NPC对话系统");
+	// 挂载资源包（不存在时读取 resource/ 下的散文件）
+	InitAssetPack("assets.pak");
 	InitFontSystem("C:\\Windows\\Fonts\\simhei.ttf");
+	InitAssetLoader();
 	
 	
 
@@ -19,12 +26,17 @@ int main() {
 	achievementSys.AddAchievement({"first", "踩踩背", "第一次踩背", false, ACH_COMMON});
 	achievementSys.AddAchievement({"rare", "超级踩背王", "踩100+个人的背", false, ACH_RARE});
 	achievementSys.AddAchievement({"zfx","同城可约","与学姐月跑",false,ACH_COMMON});
+	// 踩背次数：1 次解锁 first，100 次解锁 rare
+	int backStepStat = achievementSys.RegisterStat("back_step");
+	achievementSys.LinkStat("first", backStepStat, 1);
+	achievementSys.LinkStat("rare", backStepStat, 100);
 	achievementSys.Read();
 
 	DialogSystem dialogSystem;
-	dialogSystem.AddDialog(1, "ZFX学姐", "同城月跑，有钱月吗", "resource/zfx.png", 2);
-	dialogSystem.AddDialog(2, "ZFX学姐", "哈哈骗你的没有头月不了", "resource/zfx.png", 3);
-	dialogSystem.AddDialog(3, "general0826","没有困难的题目，只有勇敢的gengen","resource/gen.png",-1);
+	// 优先加载离线编译的对话脚本，没有时现场编译文本脚本
+	if (!dialogSystem.LoadScript("dialog/main_2.dlgb")) {
+		dialogSystem.LoadScriptSource("dialog/main_2.dlg");
+	}
 
 	// 创建系统对象
 	Character player;
@@ -40,69 +52,183 @@ int main() {
 	// 设置精灵表布局（如果素材布局不同可以修改这里）
 	// player.SetSpriteLayout(0, 1, 2, 3); // 默认就是这样的布局
 
-	// 添加碰撞箱
-	collisionSystem.AddCollisionBox({200, 200, 100, 50}, BLUE, true, "箱子1");
-	collisionSystem.AddCollisionBox({500, 300, 80, 120}, GREEN, true, "箱子2");
-	collisionSystem.AddCollisionBox({800, 150, 150, 40}, YELLOW, true, "长平台");
-	collisionSystem.AddCollisionBox({300, 500, 60, 60}, ORANGE, true, "方块");
-	collisionSystem.AddCollisionBox({700, 600, 120, 30}, PURPLE, true, "平台");
-	collisionSystem.AddCollisionBox({400, 400, 70, 70}, GRAY, false, "可穿过");
+	// 可交互的 NPC 和触发区（登记在场景文件里）：靠近后按 E 开始绑定的对话
+	InteractionSystem interactions;
+	
+	// 碰撞箱、交互项和出生点来自场景文件：优先加载离线编译的二进制，没有时现场编译文本
+	SceneInfo scene;
+	if (!LoadScene("scene/main.sceneb", &collisionSystem, nullptr, &scene, &interactions)) {
+		LoadSceneSource("scene/main.scene", &collisionSystem, nullptr, &scene, &interactions);
+	}
+	if (scene.hasSpawn) {
+		player.SetPosition(scene.spawn);
+	}
 
 	Vector2 worldSize = {screenWidth * 3, screenHeight * 3};
 	
 	Circle circle;
 
-	SetTargetFPS(60);
+	// 存档：F5 快速保存，F9 读取，每 60 秒自动保存（压缩和写盘在后台线程）
+	const std::string savePath = "save/game_2.sav";
+	double lastSaveTime = GetInputTime();
+	auto saveGame = [&]() {
+		SnapshotWriter snapshot;
+		snapshot.BeginBlock(SNAP_PLAYER);
+		player.SaveState(snapshot);
+		snapshot.EndBlock();
+		snapshot.BeginBlock(SNAP_DIALOG);
+		dialogSystem.SaveState(snapshot);
+		snapshot.EndBlock();
+		snapshot.BeginBlock(SNAP_ACHIEVEMENT);
+		achievementSys.SaveState(snapshot);
+		snapshot.EndBlock();
+		SaveSnapshotAsync(savePath, snapshot);
+		lastSaveTime = GetInputTime();
+	};
+	auto loadGame = [&]() {
+		std::vector<unsigned char> payload;
+		if (!LoadSnapshot(savePath, payload)) return;
+		SnapshotReader snapshot(payload.data(), payload.size());
+		SnapshotReader block;
+		if (snapshot.FindBlock(SNAP_PLAYER, block)) player.LoadState(block);
+		if (snapshot.FindBlock(SNAP_DIALOG, block)) dialogSystem.LoadState(block);
+		if (snapshot.FindBlock(SNAP_ACHIEVEMENT, block)) achievementSys.LoadState(block);
+		canwalk = !dialogSystem.IsActive();
+		cameraSystem.Update(player.GetPosition());
+	};
 
-	while (!WindowShouldClose()) {
+	// 回溯：按住 Backspace 逐帧倒退（最近 10 秒）
+	RewindBuffer rewind;
+	rewind.Track(player);
+	rewind.Track(dialogSystem);
+	uint64_t tick = 0;
+	
+	SetTargetFPS(60);
+	// 录制/回放输入：--record <文件> 或 --replay <文件>
+	InitInput(argc, argv);
+	// --alloc-guard：预热后报告稳态帧里的堆分配
+	InitAllocationGuard(argc, argv);
+
+	// 左上角的说明和状态文字
+	int hudPanel = CreateUiPanel();
+
+	while (!WindowShouldClose() && BeginInputFrame()) {
+		PROFILE_FRAME();
+		ResetFrameArena();
+
+		// 在预算内上传后台解码好的纹理
+		UpdateAssetLoader();
+		// 推进补间和计时器（按秒计时，与帧率无关）
+		UpdateTweens();
+		UpdateParticles();
+		UpdateUiLayer();
 		
-		if (IsKeyPressed(KEY_E) && !dialogSystem.IsActive()) {
-			dialogSystem.StartDialog(1);
-			achievementSys.Unlock("zfx");
-			canwalk = 0;
+		PROFILE_BEGIN("input");
+		bool rewinding = InputDown(KEY_BACKSPACE) && tick > rewind.OldestTick() && rewind.RewindTo(tick - 1);
+		if (rewinding) {
+			tick = rewind.NewestTick();
+			canwalk = !dialogSystem.IsActive();
+		}
+		
+		if (InputPressed(KEY_F5) || GetInputTime() - lastSaveTime > 60.0) {
+			saveGame();
+		}
+		if (InputPressed(KEY_F9)) {
+			loadGame();
+		}
+		
+		
+		// 只在附近有可交互的 NPC 时响应
+		Rectangle playerBox = player.GetCollisionBox();
+		Vector2 playerCenter = {playerBox.x + playerBox.width / 2, playerBox.y + playerBox.height / 2};
+		int nearby = dialogSystem.IsActive() ? -1 : interactions.FindNearestInteractable(playerCenter, 0.0f);
+		if (nearby >= 0 && InputPressed(KEY_E)) {
+			const Interactable& target = interactions.GetInteractable(nearby);
+			if (target.dialogId > 0) {
+				dialogSystem.StartDialog(target.dialogId);
+				canwalk = 0;
+			}
+			if (target.event == "zfx") {
+				achievementSys.Unlock("zfx");
+			}
+			nearby = -1;
 		}
 
-		if (dialogSystem.IsActive()) {
+		if (dialogSystem.IsActive() && !rewinding) {
 			dialogSystem.Update();
 			canwalk = dialogSystem.HandleInput();
 		}
 
-		if (IsKeyPressed(KEY_ONE)) {
-			achievementSys.Unlock("first");
+		if (InputPressed(KEY_ONE)) {
+			achievementSys.PostStat(backStepStat);
 		}
-		if (IsKeyPressed(KEY_TWO)) {
+		if (InputPressed(KEY_TWO)) {
 			achievementSys.Unlock("rare");
 		}
-		if(IsKeyPressed(KEY_O)) {
+		if(InputPressed(KEY_O)) {
 			circle.start();
 		}
 
+		// 分析器：F3 显示耗时叠加层，F4 导出 Chrome trace（调试按键直接读 raylib，不参与录制）
+		if (IsKeyPressed(KEY_F3)) {
+			ToggleProfilerOverlay();
+		}
+		if (IsKeyPressed(KEY_F4)) {
+			ExportProfilerTrace("save/profile.json");
+		}
+
+		PROFILE_END();
+
+		PROFILE_BEGIN("update");
 		achievementSys.Update();
 
-		float deltaTime = GetFrameTime();
+		float deltaTime = GetInputDeltaTime();
 
 		// 保存旧位置用于碰撞检测
 		Vector2 oldPosition = player.GetPosition();
-		Rectangle oldCollision = player.GetCollisionBox();
 
 		// 处理输入
-		if (canwalk) {
+		if (canwalk && !rewinding) {
 			player.HandleInput();
 			player.Update(deltaTime);
 		}
+		// 统一推进本帧登记过的角色动画
+		UpdateAnimations();
+		PROFILE_END();
 
 		// 碰撞检测
+		PROFILE_BEGIN("collision");
 		if (collisionSystem.CheckCollision(player.GetCollisionBox())) {
-			player.ResolveCollision(oldPosition, oldCollision);
+			player.ResolveCollision(oldPosition);
 		}
 
 		// 边界检查
 		player.CheckWorldBounds(worldSize);
+		
+		// 走进触发区：绑定了对话的直接开始
+		interactions.UpdateTriggers(player.GetCollisionBox());
+		for (int trigger : interactions.GetEnteredTriggers()) {
+			const TriggerVolume& volume = interactions.GetTrigger(trigger);
+			if (volume.dialogId > 0 && !dialogSystem.IsActive()) {
+				dialogSystem.StartDialog(volume.dialogId);
+				canwalk = 0;
+			}
+			TraceLog(LOG_DEBUG, "进入触发区: %s", volume.event.c_str());
+		}
+		PROFILE_END();
 
 		// 更新相机
+		PROFILE_BEGIN("camera");
 		cameraSystem.Update(player.GetPosition());
+		PROFILE_END();
+		
+		if (!rewinding) {
+			PROFILE_SCOPE("rewind record");
+			rewind.Record(++tick);
+		}
 
-		BeginDrawing();
+		PROFILE_BEGIN("world draw");
+		BeginWorldRender();
 
 		ClearBackground(SKYBLUE);
 
@@ -123,45 +249,74 @@ int main() {
 		player.Draw();
 
 		// 调试显示碰撞箱
-		if (IsKeyDown(KEY_C)) {
+		if (InputDown(KEY_C)) {
 			player.DrawCollisionDebug();
+			interactions.DrawDebug(cameraSystem.GetViewRect());
 		}
 
 		cameraSystem.EndMode();
+		EndWorldRender();
+		PROFILE_END();
 
-		// 绘制UI
-		DrawTextUTF("使用WASD或方向键移动", Vector2{10, 10}, 20, 1, DARKGRAY);
-		DrawTextUTF("按C键显示碰撞箱", Vector2{10, 40}, 20, 1, DARKGRAY);
-
-		// 显示角色状态
-		std::string statusText = "状态: " +
-		                         CharacterUtils::StateToString(player.GetState()) + " - " +
-		                         CharacterUtils::DirectionToString(player.GetDirection());
-		DrawTextUTF(statusText, Vector2{10, 70}, 20, 1, DARKBLUE);
+		// 世界层拉伸到窗口，UI 按原生分辨率画在上面
+		BeginDrawing();
+		DrawWorldRender();
 
-		if (!textureLoaded) {
-			DrawTextUTF("无法加载角色纹理，使用替代图形", Vector2{10, 100}, 20, 1, ORANGE);
+		// 绘制UI
+		PROFILE_BEGIN("ui draw");
+		// 说明文字和角色状态缓存在面板里，状态变化时才重画
+		const char* statusText = FrameFormat("状态: %s - %s",
+		                                      CharacterUtils::StateToString(player.GetState()),
+		                                      CharacterUtils::DirectionToString(player.GetDirection()));
+		if (BeginUiPanel(hudPanel, 400, 120, MixUiKey(MixUiKey(UI_KEY_SEED, statusText), (int64_t)textureLoaded))) {
+			DrawTextUTF("使用WASD或方向键移动", Vector2{0, 0}, 20, 1, DARKGRAY);
+			DrawTextUTF("按C键显示碰撞箱", Vector2{0, 30}, 20, 1, DARKGRAY);
+			DrawTextUTF(statusText, Vector2{0, 60}, 20, 1, DARKBLUE);
+			if (!textureLoaded) {
+				DrawTextUTF("无法加载角色纹理，使用替代图形", Vector2{0, 90}, 20, 1, ORANGE);
+			}
+			EndUiPanel();
 		}
+		DrawUiPanel(hudPanel, {10, 10});
 
 		DrawFPS(screenWidth - 100, 10);
+		if (IsProfilerOverlayVisible()) {
+			DrawText(TextFormat("ui redraws: %d", GetUiPanelRedraws()), screenWidth - 100, 35, 10, DARKGRAY);
+		}
 
 		achievementSys.Draw();
+		DrawParticles(PARTICLE_SCREEN);
 
 		if (dialogSystem.IsActive()) dialogSystem.Draw();
 
-		DrawTextUTF("按 E 开始对话", {10, 10}, 20, 1, DARKGRAY);
+		if (nearby >= 0) {
+			DrawTextUTF("按 E 开始对话", {10, 10}, 20, 1, DARKGRAY);
+		}
 		
 		circle.out(canwalk,screenHeight,screenWidth);
 		circle.photo(screenHeight,screenWidth);
-		circle.in(canwalk,screenHeight,screenWidth);
-		
+		circle.in(canwalk);
 		
+		DrawProfilerOverlay();
+		PROFILE_END();
+
+		PROFILE_BEGIN("EndDrawing");
 		EndDrawing();
+		PROFILE_END();
+
+		// 按帧耗时调整世界层的渲染比例
+		UpdateRenderScale();
 	}
 
+	UnloadInput();
 	UnloadFontSystem();
+	FlushSnapshots();
 	achievementSys.Save();
 	player.UnloadResources();
+	UnloadAssetLoader();
+	UnloadAssetPack();
+	UnloadUiLayer();
+	UnloadRenderScale();
 	CloseWindow();
 	return 0;
 }
@@ -2,21 +2,35 @@
 #include <memory>
 #include <string>
 #include <iostream>
-#include "1.h"
+#include "include/character.h"
+#include "include/scene.h"
+#include "include/rewind.h"
+#include "include/particles.h"
+#include "include/interaction.h"
+#include "include/uilayer.h"
 
 const int SCREEN_WIDTH = 800;
 const int SCREEN_HEIGHT = 600;
 
-int main() {
+int main(int argc, char** argv) {
 	// 初始化窗口
 	InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "完整的物体碰撞系统");
+	// 挂载资源包（不存在时读取 resource/ 下的散文件）
+	InitAssetPack("assets.pak");
 	SetTargetFPS(60);
+	// 录制/回放输入：--record <文件> 或 --replay <文件>
+	InitInput(argc, argv);
+	// --alloc-guard：预热后报告稳态帧里的堆分配
+	InitAllocationGuard(argc, argv);
 	
 	// 初始化字体系统
 	if (!InitFontSystem("C:\\Windows\\Fonts\\simhei.ttf")) {
 		TraceLog(LOG_WARNING, "无法加载字体文件，使用默认字体");
 	}
 	
+	// 启动后台资源加载线程
+	InitAssetLoader();
+	
 	// 创建物体管理系统
 	GameObjectSystem gameObjects;
 	CameraSystem camera;
@@ -28,72 +42,163 @@ int main() {
 	} else {
 		TraceLog(LOG_WARNING, "使用备用角色贴图");
 	}
-	player->SetPosition({400, 300});
 	player->SetSpeed(150.0f);
 	player->SetAnimationSpeed(0.15f);
 	player->SetSpriteLayout(0, 1, 2, 3);
-	gameObjects.AddObject("player", player);
 	
-	// 创建障碍物
-	auto obstacle1 = std::make_shared<ImageObject>("resource/zfx.png", "rock1");
-	obstacle1->SetPosition({200, 200});
-	obstacle1->SetScale(0.8f);
-	obstacle1->AddCollisionComponent({10, 10, 40, 40}, RED, true, "rock_collision");
-	gameObjects.AddObject("rock1", obstacle1);
-	
-	auto obstacle2 = std::make_shared<ImageObject>("assets/tree.png", "tree1");
-	obstacle2->SetPosition({600, 400});
-	obstacle2->SetScale(1.2f);
-	obstacle2->AddCollisionComponent({15, 60, 30, 20}, BLUE, true, "tree_trunk");
-	gameObjects.AddObject("tree1", obstacle2);
+	// 障碍物、可收集物品和出生点来自场景文件：优先加载离线编译的二进制，没有时现场编译文本
+	SceneInfo scene;
+	if (!LoadScene("scene/main_4.sceneb", nullptr, &gameObjects, &scene)) {
+		LoadSceneSource("scene/main_4.scene", nullptr, &gameObjects, &scene);
+	}
+	Vector2 spawn = scene.hasSpawn ? scene.spawn : Vector2{400, 300};
+	player->SetPosition(spawn);
+	gameObjects.AddObject("player", player);
 	
-	// 创建可收集物品
-	auto coin = std::make_shared<ImageObject>("assets/coin.png", "coin1");
-	coin->SetPosition({300, 500});
-	coin->SetScale(0.5f);
-	coin->AddCollisionComponent({5, 5, 20, 20}, YELLOW, false, "coin_area");
-	gameObjects.AddObject("coin1", coin);
+	// 带 coin 标签的物体的非实心碰撞箱 coin_area 登记为触发区，事件名是金币的 id，走进去就收集
+	const TagId coinTag = InternTag("coin");
+	InteractionSystem interactions;
+	std::vector<int> coinTriggers;
+	for (const ObjectEntry* coin : gameObjects.GetObjectsWithTag(coinTag)) {
+		const GameObject& obj = *coin->second;
+		const std::vector<CollisionComponent>& components = obj.GetCollisionComponents();
+		for (size_t i = 0; i < components.size(); ++i) {
+			if (components[i].name == "coin_area") {
+				coinTriggers.push_back(interactions.AddTrigger(obj.GetWorldCollisionRects()[i], 0, coin->first));
+			}
+		}
+	}
+	// 读档、回溯、重置之后金币的可见性变了，触发区跟着金币走：看得见的才能收集
+	auto syncCoinTriggers = [&]() {
+		for (int trigger : coinTriggers) {
+			const GameObject* coin = gameObjects.FindObject(interactions.GetTrigger(trigger).event);
+			interactions.SetTriggerEnabled(trigger, coin && coin->IsVisible());
+		}
+	};
 	
 	// 游戏状态
 	bool showDebug = true;
 	bool collisionOccurred = false;
-	std::string collisionInfo;
+	const char* collisionInfo = ""; // 帧内存，每帧重新生成
 	int score = 0;
 	
+	// 存档：F5 快速保存，F9 读取，每 60 秒自动保存（压缩和写盘在后台线程）
+	const std::string savePath = "save/objects.sav";
+	double lastSaveTime = GetInputTime();
+	auto saveGame = [&]() {
+		SnapshotWriter snapshot;
+		snapshot.BeginBlock(SNAP_OBJECTS);
+		gameObjects.SaveState(snapshot);
+		snapshot.EndBlock();
+		snapshot.BeginBlock(SNAP_USER);
+		snapshot.Write((int32_t)score);
+		snapshot.EndBlock();
+		SaveSnapshotAsync(savePath, snapshot);
+		lastSaveTime = GetInputTime();
+	};
+	auto loadGame = [&]() {
+		std::vector<unsigned char> payload;
+		if (!LoadSnapshot(savePath, payload)) return;
+		SnapshotReader snapshot(payload.data(), payload.size());
+		SnapshotReader block;
+		int32_t savedScore = 0;
+		if (snapshot.FindBlock(SNAP_OBJECTS, block)) gameObjects.LoadState(block);
+		if (snapshot.FindBlock(SNAP_USER, block) && block.Read(savedScore)) score = savedScore;
+		syncCoinTriggers();
+	};
+	
+	// 回溯：按住 Backspace 逐帧倒退（最近 10 秒），只记录动过的物体
+	RewindBuffer rewind;
+	rewind.TrackObjects(gameObjects);
+	rewind.Track([&](SnapshotWriter& out) {
+		out.Write((int32_t)score);
+	}, [&](SnapshotReader& in) {
+		int32_t saved = 0;
+		if (!in.Read(saved)) return false;
+		score = saved;
+		return true;
+	});
+	uint64_t tick = 0;
+	
+	// 左下角的操作说明
+	int helpPanel = CreateUiPanel();
+	
 	// 游戏主循环
-	while (!WindowShouldClose()) {
-		float deltaTime = GetFrameTime();
+	while (!WindowShouldClose() && BeginInputFrame()) {
+		PROFILE_FRAME();
+		ResetFrameArena();
+		
+		// 在预算内上传后台解码好的纹理
+		UpdateAssetLoader();
+		UpdateParticles();
+		UpdateUiLayer();
+		
+		PROFILE_BEGIN("input");
+		if (InputPressed(KEY_F5) || GetInputTime() - lastSaveTime > 60.0) {
+			saveGame();
+		}
+		if (InputPressed(KEY_F9)) {
+			loadGame();
+		}
+		// 分析器：F3 显示耗时叠加层，F4 导出 Chrome trace（调试按键直接读 raylib，不参与录制）
+		if (IsKeyPressed(KEY_F3)) {
+			ToggleProfilerOverlay();
+		}
+		if (IsKeyPressed(KEY_F4)) {
+			ExportProfilerTrace("save/profile.json");
+		}
+		PROFILE_END();
 		
-		// 处理输入
-		player->HandleInput();
+		PROFILE_BEGIN("update");
+		float deltaTime = GetInputDeltaTime();
 		
-		// 更新
-		player->Update(deltaTime);
+		bool rewinding = InputDown(KEY_BACKSPACE) && tick > rewind.OldestTick() && rewind.RewindTo(tick - 1);
+		if (rewinding) {
+			tick = rewind.NewestTick();
+			syncCoinTriggers();
+		} else {
+			// 处理输入
+			player->HandleInput();
+			
+			// 更新
+			player->Update(deltaTime);
+		}
+		// 统一推进本帧登记过的角色动画
+		UpdateAnimations();
 		
 		// 检查世界边界
 		player->CheckWorldBounds({SCREEN_WIDTH, SCREEN_HEIGHT});
+		PROFILE_END();
 		
 		// 碰撞检测
+		PROFILE_BEGIN("collision");
 		collisionOccurred = false;
+		// 收集金币时的金色火花
+		auto collectCoin = [&](const std::string& id) {
+			GameObject* coin = gameObjects.FindObject(id);
+			if (!coin) return;
+			coin->SetVisible(false);
+			score++;
+			Rectangle bounds = coin->GetBounds();
+			ParticleEffect burst;
+			burst.count = 48;
+			burst.speedMin = 80.0f;
+			burst.speedMax = 220.0f;
+			burst.lifeMin = 0.3f;
+			burst.lifeMax = 0.6f;
+			burst.drag = 3.0f;
+			burst.colorStart = GOLD;
+			burst.colorEnd = {255, 240, 150, 0};
+			EmitParticles(burst, {bounds.x + bounds.width / 2, bounds.y + bounds.height / 2});
+			collisionInfo = FrameFormat("%s (收集!)", collisionInfo);
+		};
 		gameObjects.CheckAllCollisions([&](const std::string& id1, const std::string& id2) {
 			collisionOccurred = true;
-			collisionInfo = "碰撞: " + id1 + " ↔ " + id2;
+			collisionInfo = FrameFormat("碰撞: %s ↔ %s", id1.c_str(), id2.c_str());
 			
 			// 处理玩家碰撞
 			if (id1 == "player" || id2 == "id2") {
 				player->ResolveCollision();
-				
-				// 处理可收集物品
-				if (id1.find("coin") != std::string::npos) {
-					gameObjects.GetObject(id1)->SetVisible(false);
-					score++;
-					collisionInfo += " (收集!)";
-				}
-				if (id2.find("coin") != std::string::npos) {
-					gameObjects.GetObject(id2)->SetVisible(false);
-					score++;
-					collisionInfo += " (收集!)";
-				}
 			}
 		});
 		
@@ -101,37 +206,77 @@ int main() {
 			collisionInfo = "无碰撞";
 		}
 		
+		// 处理可收集物品：只查询玩家附近的触发区
+		interactions.UpdateTriggers(player->GetCollisionBox());
+		for (int trigger : interactions.GetEnteredTriggers()) {
+			collectCoin(interactions.GetTrigger(trigger).event);
+			interactions.SetTriggerEnabled(trigger, false);
+		}
+		PROFILE_END();
+		
 		// 更新相机
+		PROFILE_BEGIN("camera");
 		camera.Update(player->GetPosition());
+		PROFILE_END();
+		
+		if (!rewinding) {
+			PROFILE_SCOPE("rewind record");
+			rewind.Record(++tick);
+		}
 		
 		// 绘制
-		BeginDrawing();
+		PROFILE_BEGIN("world draw");
+		BeginWorldRender();
 		ClearBackground(RAYWHITE);
 		
 		camera.BeginMode();
 		gameObjects.DrawAll();
+		DrawParticles(PARTICLE_WORLD);
 		if (showDebug) {
 			gameObjects.DrawAllDebug();
+			interactions.DrawDebug(camera.GetViewRect());
 		}
 		camera.EndMode();
+		EndWorldRender();
+		PROFILE_END();
+		
+		// 世界层拉伸到窗口，UI 按原生分辨率画在上面
+		BeginDrawing();
+		DrawWorldRender();
 		
 		// UI信息
+		PROFILE_BEGIN("ui draw");
 		DrawText(TextFormat("分数: %d", score), 10, 10, 20, BLACK);
 		DrawText(TextFormat("物体数量: %d", gameObjects.Count()), 10, 40, 20, BLACK);
 		DrawText(TextFormat("玩家位置: (%.1f, %.1f)", 
 							player->GetPosition().x, player->GetPosition().y), 10, 70, 20, BLACK);
-		DrawText(collisionInfo.c_str(), 10, 100, 20, collisionOccurred ? RED : GREEN);
+		DrawText(collisionInfo, 10, 100, 20, collisionOccurred ? RED : GREEN);
+		
+		// 操作说明（内容不变，只画一次）
+		if (BeginUiPanel(helpPanel, 400, 110, UI_KEY_SEED)) {
+			DrawText("WASD/方向键: 移动", 0, 0, 20, DARKGRAY);
+			DrawText("F1: 切换调试显示", 0, 30, 20, DARKGRAY);
+			DrawText("R: 重置场景  F5/F9: 保存/读取", 0, 60, 20, DARKGRAY);
+			DrawText("ESC: 退出", 0, 90, 20, DARKGRAY);
+			EndUiPanel();
+		}
+		DrawUiPanel(helpPanel, {10, SCREEN_HEIGHT - 120});
 		
-		// 操作说明
-		DrawText("WASD/方向键: 移动", 10, SCREEN_HEIGHT - 120, 20, DARKGRAY);
-		DrawText("F1: 切换调试显示", 10, SCREEN_HEIGHT - 90, 20, DARKGRAY);
-		DrawText("R: 重置场景", 10, SCREEN_HEIGHT - 60, 20, DARKGRAY);
-		DrawText("ESC: 退出", 10, SCREEN_HEIGHT - 30, 20, DARKGRAY);
+		DrawProfilerOverlay(10, 130);
+		if (IsProfilerOverlayVisible()) {
+			DrawText(TextFormat("ui redraws: %d", GetUiPanelRedraws()), SCREEN_WIDTH - 100, 10, 10, DARKGRAY);
+		}
+		PROFILE_END();
 		
+		PROFILE_BEGIN("EndDrawing");
 		EndDrawing();
+		PROFILE_END();
+		
+		// 按帧耗时调整世界层的渲染比例
+		UpdateRenderScale();
 		
 		// 额外控制
-		if (IsKeyPressed(KEY_F1)) {
+		if (InputPressed(KEY_F1)) {
 			showDebug = !showDebug;
 			// 切换所有物体的碰撞箱显示
 			for (const auto& [id, obj] : gameObjects.GetAllObjects()) {
@@ -139,21 +284,26 @@ int main() {
 			}
 		}
 		
-		if (IsKeyPressed(KEY_R)) {
+		if (InputPressed(KEY_R)) {
 			// 重置场景
-			player->SetPosition({400, 300});
+			player->SetPosition(spawn);
 			score = 0;
 			// 重新显示所有可收集物品
-			for (const auto& [id, obj] : gameObjects.GetAllObjects()) {
-				if (id.find("coin") != std::string::npos) {
-					obj->SetVisible(true);
-				}
+			for (const ObjectEntry* coin : gameObjects.GetObjectsWithTag(coinTag)) {
+				coin->second->SetVisible(true);
 			}
+			syncCoinTriggers();
 		}
 	}
 	
 	// 清理资源
+	FlushSnapshots();
+	UnloadInput();
 	UnloadFontSystem();
+	UnloadAssetLoader();
+	UnloadAssetPack();
+	UnloadUiLayer();
+	UnloadRenderScale();
 	CloseWindow();
 	
 	return 0;
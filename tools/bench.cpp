@@ -0,0 +1,536 @@
+// 性能基准：碰撞、字体缓存、物体系统、按标签查询、对话系统、寻路、粒子、动画、模拟 LOD、交互查询和场景加载的热点路径
+//
+// 用法: bench [名称过滤] [-t 每项最短秒数]
+//
+// 不创建窗口，可在无显示的 Linux 上运行。每一项按几组规模运行，输出
+// 每次操作耗时（ns/op）、每次操作的堆分配次数（alloc/op）和相对上一组规模的增长倍数，
+// 改动引擎代码前后各跑一次对比即可。
+// 场景由固定种子的生成器构造，多次运行结果可比。
+#define NB_ALLOC_HOOK // 发布版编译时也保留分配统计（见 framemem.h）
+#include "raylib.h"
+#include "../include/character.h"
+#include "../include/dialog.h"
+#include "../include/navigation.h"
+#include "../include/particles.h"
+#include "../include/interaction.h"
+#include "../include/scene.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+// ==================== 计时 ====================
+
+struct BenchResult {
+	double nsPerOp;
+	double allocsPerOp;
+};
+
+static double benchMinSeconds = 0.2;
+static volatile uint64_t benchSink = 0; // 防止被测代码被优化掉
+
+/// 反复调用 op（每次调用计 1 次操作），迭代次数翻倍直到总时间超过 benchMinSeconds
+template<typename Op>
+BenchResult RunBench(Op&& op) {
+	using Clock = std::chrono::steady_clock;
+	op(); // 预热
+
+	uint64_t iterations = 1;
+	while (true) {
+		uint64_t allocsBefore = GetAllocCounters().count; // 只统计本线程，资源加载线程不计入
+		auto start = Clock::now();
+		for (uint64_t i = 0; i < iterations; ++i) op();
+		double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+		uint64_t allocs = GetAllocCounters().count - allocsBefore;
+
+		if (elapsed >= benchMinSeconds || iterations >= (1ull << 40)) {
+			return {elapsed * 1e9 / iterations, (double)allocs / iterations};
+		}
+		// 按已测速度估算，最多放大 10 倍
+		double scale = elapsed > 0 ? benchMinSeconds * 1.2 / elapsed : 10.0;
+		iterations = (uint64_t)(iterations * (scale < 2 ? 2 : (scale > 10 ? 10 : scale)));
+	}
+}
+
+/// 一组规模下的结果，打印成一张表
+struct BenchSeries {
+	std::string name;
+	std::string unit; // 规模的含义，如 "boxes"
+	std::vector<std::pair<int, BenchResult>> points;
+
+	void Print() const {
+		printf("%-40s %8s %14s %10s %8s\n", name.c_str(), unit.c_str(), "ns/op", "alloc/op", "x");
+		for (size_t i = 0; i < points.size(); ++i) {
+			const BenchResult& r = points[i].second;
+			if (i == 0) {
+				printf("%-40s %8d %14.1f %10.2f %8s\n", "", points[i].first, r.nsPerOp, r.allocsPerOp, "-");
+			} else {
+				printf("%-40s %8d %14.1f %10.2f %8.2f\n", "", points[i].first, r.nsPerOp, r.allocsPerOp,
+				       r.nsPerOp / points[i - 1].second.nsPerOp);
+			}
+		}
+		printf("\n");
+		fflush(stdout);
+	}
+};
+
+// ==================== 场景生成 ====================
+
+static const float BENCH_WORLD = 10000.0f;
+
+/// N 个随机分布的碰撞箱
+static void MakeBoxes(CollisionSystem& system, int count, unsigned seed) {
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> pos(0, BENCH_WORLD);
+	std::uniform_real_distribution<float> size(20, 200);
+	for (int i = 0; i < count; ++i) {
+		system.AddCollisionBox({pos(rng), pos(rng), size(rng), size(rng)}, GRAY, true, "box" + std::to_string(i));
+	}
+}
+
+/// 不依赖纹理的物体，只有一个碰撞箱
+class BenchMover : public GameObject {
+public:
+	explicit BenchMover(const std::string& objId) : GameObject(objId) {}
+	void Draw() const override {}
+	Rectangle GetBounds() const override { return {position.x, position.y, 32, 32}; }
+	void Update(float deltaTime) override {
+		// 缓慢漂移，让 LOD 的空间索引也有重新归格的开销
+		position.x += 8.0f * deltaTime;
+		MarkBoundsDirty();
+	}
+};
+
+/// M 个随机分布的移动物体，密度与 M 无关（场景边长随 sqrt(M) 增长）
+static void MakeMovers(GameObjectSystem& system, int count, unsigned seed) {
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> pos(0, 64.0f * std::sqrt((float)count));
+	for (int i = 0; i < count; ++i) {
+		std::string id = "mover" + std::to_string(i);
+		auto mover = std::make_shared<BenchMover>(id);
+		mover->SetPosition({pos(rng), pos(rng)});
+		mover->AddCollisionComponent({0, 0, 32, 32}, RED, true, "body");
+		system.AddObject(id, mover);
+	}
+}
+
+/// K 个互不相同的中英文混合字符串
+static std::vector<std::string> MakeStrings(int count, unsigned seed) {
+	static const char* words[] = {"同城", "月跑", "学姐", "Hello", "背", "成就", "解锁", "gengen", "对话", "选项"};
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<int> pick(0, 9);
+	std::uniform_int_distribution<int> length(2, 8);
+	std::vector<std::string> strings;
+	for (int i = 0; i < count; ++i) {
+		std::string text = std::to_string(i);
+		for (int w = length(rng); w > 0; --w) text += words[pick(rng)];
+		strings.push_back(text);
+	}
+	return strings;
+}
+
+/// K 个节点的对话脚本（每个节点接下一个，每 4 个节点带两个选项），返回脚本路径
+static std::string MakeDialogScript(int count, unsigned seed) {
+	std::vector<std::string> lines = MakeStrings(count, seed);
+	std::string path = (std::filesystem::temp_directory_path() / ("bench_" + std::to_string(count) + ".dlg")).string();
+	std::ofstream out(path, std::ios::binary);
+	for (int id = 1; id <= count; ++id) {
+		out << "[" << id << "] 角色" << id % 7 << "\n" << lines[id - 1] << "\n";
+		if (id % 4 == 0) {
+			out << "* 好啊 -> " << (id % count) + 1 << "\n";
+			out << "* 不了 -> " << ((id * 7) % count) + 1 << "\n";
+		} else if (id < count) {
+			out << "-> " << id + 1 << "\n";
+		}
+		out << "\n";
+	}
+	return path;
+}
+
+/// N 个碰撞箱和 N/10 个带碰撞箱的物体的文本场景，返回场景路径
+static std::string MakeSceneSource(int count, unsigned seed) {
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> pos(0, BENCH_WORLD);
+	std::uniform_real_distribution<float> size(20, 200);
+	std::string path = (std::filesystem::temp_directory_path() / ("bench_" + std::to_string(count) + ".scene")).string();
+	std::ofstream out(path, std::ios::binary);
+	out << "spawn 0 0\n";
+	for (int i = 0; i < count; ++i) {
+		out << "box " << pos(rng) << " " << pos(rng) << " " << size(rng) << " " << size(rng) << " 1 GRAY box" << i << "\n";
+	}
+	for (int i = 0; i < count / 10; ++i) {
+		out << "object obj" << i << " assets/coin.png " << pos(rng) << " " << pos(rng) << " 0.5\n";
+		out << "collide 0 0 32 32 1 RED body\n";
+	}
+	return path;
+}
+
+// ==================== 基准项 ====================
+
+static void BenchCollisionQuery() {
+	BenchSeries series{"CollisionSystem::CheckCollision", "boxes", {}};
+	for (int count : {100, 1000, 10000}) {
+		CollisionSystem system;
+		MakeBoxes(system, count, 1);
+		std::mt19937 rng(2);
+		std::uniform_real_distribution<float> pos(0, BENCH_WORLD);
+		std::vector<Rectangle> queries;
+		for (int i = 0; i < 1024; ++i) queries.push_back({pos(rng), pos(rng), 32, 48});
+
+		size_t next = 0;
+		series.points.push_back({count, RunBench([&] {
+			benchSink += system.CheckCollision(queries[next++ & 1023]);
+		})});
+	}
+	series.Print();
+}
+
+static void BenchAllCollisions() {
+	BenchSeries series{"GameObjectSystem::CheckAllCollisions", "movers", {}};
+	for (int count : {50, 200, 800}) {
+		GameObjectSystem system;
+		MakeMovers(system, count, 3);
+		series.points.push_back({count, RunBench([&] {
+			ResetFrameArena(); // 相当于每帧调用一次
+			system.CheckAllCollisions([](const std::string&, const std::string&) {
+				++benchSink;
+			});
+		})});
+	}
+	series.Print();
+}
+
+static void BenchGetObject() {
+	BenchSeries series{"GameObjectSystem::GetObject", "objects", {}};
+	for (int count : {100, 1000, 10000}) {
+		GameObjectSystem system;
+		MakeMovers(system, count, 4);
+		std::vector<std::string> ids;
+		std::mt19937 rng(5);
+		std::uniform_int_distribution<int> pick(0, count - 1);
+		for (int i = 0; i < 1024; ++i) ids.push_back("mover" + std::to_string(pick(rng)));
+
+		size_t next = 0;
+		series.points.push_back({count, RunBench([&] {
+			benchSink += system.GetObject(ids[next++ & 1023]) != nullptr;
+		})});
+	}
+	series.Print();
+}
+
+static void BenchTagQuery() {
+	// 每 32 个物体里有 1 个带 coin 标签，查询耗时应只随标签成员数增长
+	BenchSeries series{"GameObjectSystem::CheckCollisionWithType", "objects", {}};
+	for (int count : {1000, 10000, 100000}) {
+		GameObjectSystem system;
+		MakeMovers(system, count, 12);
+		TagId coin = InternTag("coin");
+		int index = 0;
+		for (const auto& [id, obj] : system.GetAllObjects()) {
+			if (index++ % 32 == 0) obj->AddTag(coin);
+		}
+		series.points.push_back({count, RunBench([&] {
+			benchSink += system.CheckCollisionWithType("mover0", "coin");
+		})});
+	}
+	series.Print();
+}
+
+static void BenchFontCache() {
+	// 无窗口时不能创建字体纹理，只测缓存命中路径：先放入空字体占位
+	BenchSeries series{"GetDynamicFont (cache hit)", "strings", {}};
+	for (int count : {16, 256, 4096}) {
+		std::vector<std::string> strings = MakeStrings(count, 6);
+		for (const auto& text : strings) {
+			fntCache.insert({text + "_20", Font{}});
+		}
+
+		size_t next = 0;
+		series.points.push_back({count, RunBench([&] {
+			benchSink += GetDynamicFont(strings[next++ % strings.size()].c_str(), 20).baseSize;
+		})});
+		fntCache.clear();
+	}
+	series.Print();
+}
+
+static void BenchDialog() {
+	BenchSeries start{"DialogSystem::StartDialog", "nodes", {}};
+	BenchSeries update{"DialogSystem::Update (GetCurrentDialog)", "nodes", {}};
+	for (int count : {16, 256, 4096}) {
+		std::string path = MakeDialogScript(count, 7);
+		DialogSystem dialogSystem;
+		dialogSystem.SetPrefetchDepth(0); // 只测节点查找，不沿路径预取立绘
+		if (!dialogSystem.LoadScriptSource(path)) {
+			fprintf(stderr, "无法加载生成的对话脚本: %s\n", path.c_str());
+			continue;
+		}
+
+		int next = 0;
+		start.points.push_back({count, RunBench([&] {
+			dialogSystem.StartDialog(next++ % count + 1);
+		})});
+		// 每帧路径：Update 内通过 GetCurrentDialog 取当前节点
+		dialogSystem.StartDialog(1);
+		update.points.push_back({count, RunBench([&] {
+			dialogSystem.Update();
+			benchSink += dialogSystem.IsActive();
+		})});
+		std::filesystem::remove(path);
+	}
+	start.Print();
+	update.Print();
+}
+
+static void BenchPathfinding() {
+	// 每次操作是一条没有缓存的新路径，从请求到搜索完成
+	BenchSeries series{"NavigationSystem (A* uncached)", "cells", {}};
+	for (int side : {64, 128, 256}) {
+		CollisionSystem system;
+		float worldSide = side * 16.0f;
+		std::mt19937 rng(6);
+		std::uniform_real_distribution<float> pos(0, worldSide);
+		std::uniform_real_distribution<float> size(20, 120);
+		for (int i = 0; i < side * side / 64; ++i) {
+			system.AddCollisionBox({pos(rng), pos(rng), size(rng), size(rng)}, GRAY, true);
+		}
+		NavigationSystem navigation(system);
+		navigation.Build({0, 0, worldSide, worldSide}, 16.0f, 8.0f);
+
+		std::vector<std::pair<Vector2, Vector2>> queries;
+		while (queries.size() < 1024) {
+			Vector2 from = {pos(rng), pos(rng)};
+			Vector2 to = {pos(rng), pos(rng)};
+			if (!navigation.IsBlocked(from) && !navigation.IsBlocked(to)) queries.push_back({from, to});
+		}
+
+		size_t next = 0;
+		series.points.push_back({side * side, RunBench([&] {
+			const auto& query = queries[next++ & 1023];
+			PathHandle path = navigation.RequestPath(query.first, query.second);
+			while (!path->IsDone()) navigation.Update(1.0);
+			benchSink += path->points.size();
+			navigation.InvalidateArea({0, 0, 1, 1}); // 作废缓存，下一轮重新搜索
+		})});
+	}
+	series.Print();
+}
+
+static void BenchFlowField() {
+	BenchSeries build{"BuildFlowFieldData", "cells", {}};
+	BenchSeries sample{"FlowField::Sample", "cells", {}};
+	for (int side : {64, 128, 256}) {
+		CollisionSystem system;
+		float worldSide = side * 16.0f;
+		std::mt19937 rng(7);
+		std::uniform_real_distribution<float> pos(0, worldSide);
+		std::uniform_real_distribution<float> size(20, 120);
+		for (int i = 0; i < side * side / 64; ++i) {
+			system.AddCollisionBox({pos(rng), pos(rng), size(rng), size(rng)}, GRAY, true);
+		}
+		NavigationSystem navigation(system);
+		navigation.Build({0, 0, worldSide, worldSide}, 16.0f, 8.0f);
+
+		// 目标取中心附近第一个可走的格子
+		std::vector<uint8_t> grid(side * side, 0);
+		for (int cell = 0; cell < side * side; ++cell) {
+			grid[cell] = navigation.IsBlocked(navigation.CellCenter(cell));
+		}
+		int goal = side * side / 2 + side / 2;
+		while (grid[goal]) ++goal;
+		FlowFieldHandle field = navigation.RequestFlowField(navigation.CellCenter(goal));
+		navigation.Update(1.0);
+
+		// 直接调用计算函数，不经过缓存
+		FlowFieldData data;
+		data.area = {0, 0, worldSide, worldSide};
+		data.cellSize = 16.0f;
+		data.width = side;
+		data.height = side;
+		data.goalCell = goal;
+		std::vector<std::pair<float, int>> heap;
+		build.points.push_back({side * side, RunBench([&] {
+			BuildFlowFieldData(data, grid, heap);
+			benchSink += data.direction[0];
+		})});
+
+		std::vector<Vector2> agents;
+		for (int i = 0; i < 1024; ++i) agents.push_back({pos(rng), pos(rng)});
+		size_t next = 0;
+		sample.points.push_back({side * side, RunBench([&] {
+			Vector2 direction = field->Sample(agents[next++ & 1023]);
+			benchSink += direction.x > 0;
+		})});
+	}
+	build.Print();
+	sample.Print();
+}
+
+static void BenchParticles() {
+	// 每次操作推进一帧；粒子寿命按 60 FPS 约 2 秒，稳态下每帧有 1/120 到期并补发
+	BenchSeries series{"IntegrateParticles (one frame)", "live", {}};
+	SetParticleCapacity(1 << 17);
+	for (int count : {1000, 10000, 100000}) {
+		ClearParticles();
+		ParticleEffect effect;
+		effect.lifeMin = 1.0f;
+		effect.lifeMax = 3.0f;
+		effect.gravity = {0.0f, 200.0f};
+		effect.drag = 0.5f;
+		EmitParticles(effect, {0, 0}, count);
+		ParticlePool& pool = GetParticlePool(effect.texture, effect.layer);
+
+		series.points.push_back({count, RunBench([&] {
+			IntegrateParticles(pool, 1.0f / 60.0f);
+			EmitParticles(effect, {0, 0}, count - pool.count);
+			benchSink += pool.count;
+		})});
+	}
+	series.Print();
+}
+
+static void BenchAnimation() {
+	// 每次操作是一帧：所有实例登记推进，再统一更新
+	BenchSeries series{"UpdateAnimations (one frame)", "walkers", {}};
+	for (int count : {100, 1000, 10000}) {
+		std::vector<AnimatorId> animators;
+		for (int i = 0; i < count; ++i) {
+			animators.push_back(CreateAnimator());
+		}
+		series.points.push_back({count, RunBench([&] {
+			for (AnimatorId id : animators) TickAnimator(id, true, 1.0f / 60.0f);
+			UpdateAnimations();
+			benchSink += GetAnimatorFrame(animators[0]);
+		})});
+		for (AnimatorId id : animators) DestroyAnimator(id);
+	}
+	series.Print();
+}
+
+static void BenchSimulationLod() {
+	// 每次操作是一帧；密度固定，关注点附近的物体数不随总数变化
+	BenchSeries all{"GameObjectSystem::UpdateAll", "objects", {}};
+	BenchSeries lod{"GameObjectSystem::UpdateAll (LOD)", "objects", {}};
+	for (int count : {1000, 10000, 100000}) {
+		GameObjectSystem system;
+		MakeMovers(system, count, 9);
+		all.points.push_back({count, RunBench([&] {
+			system.UpdateAll(1.0f / 60.0f);
+		})});
+		system.EnableSimulationLod(600.0f, 1200.0f, 4);
+		system.SetLodFocus({1000.0f, 1000.0f});
+		lod.points.push_back({count, RunBench([&] {
+			system.UpdateAll(1.0f / 60.0f);
+			benchSink += system.GetAwakeObjectCount();
+		})});
+	}
+	all.Print();
+	lod.Print();
+}
+
+static void BenchInteraction() {
+	// 每次操作是一帧：找最近的可交互点，再检查触发区
+	BenchSeries series{"InteractionSystem (one frame)", "entries", {}};
+	for (int count : {100, 1000, 10000}) {
+		InteractionSystem system;
+		std::mt19937 rng(10);
+		std::uniform_real_distribution<float> pos(0, BENCH_WORLD);
+		std::uniform_real_distribution<float> size(20, 200);
+		for (int i = 0; i < count; ++i) {
+			system.AddInteractable({pos(rng), pos(rng)}, 60.0f, 1);
+			system.AddTrigger({pos(rng), pos(rng), size(rng), size(rng)}, 0);
+		}
+		std::vector<Vector2> players;
+		for (int i = 0; i < 1024; ++i) players.push_back({pos(rng), pos(rng)});
+
+		size_t next = 0;
+		series.points.push_back({count, RunBench([&] {
+			Vector2 player = players[next++ & 1023];
+			benchSink += system.FindNearestInteractable(player, 0.0f) + 1;
+			system.UpdateTriggers({player.x - 16, player.y - 16, 32, 32});
+			benchSink += system.GetEnteredTriggers().size();
+		})});
+	}
+	series.Print();
+}
+
+static void BenchSceneLoad() {
+	// 每次操作加载一次场景并做一次碰撞查询（文本加载要现场编译并建网格）
+	BenchSeries binary{"LoadScene (binary)", "boxes", {}};
+	BenchSeries source{"LoadSceneSource (text)", "boxes", {}};
+	for (int count : {100, 1000, 10000}) {
+		std::string path = MakeSceneSource(count, 11);
+		std::string compiledPath = path + "b";
+		{
+			std::ifstream in(path, std::ios::binary);
+			std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+			std::vector<unsigned char> compiled;
+			std::string error;
+			CompileScene(text, compiled, error);
+			std::ofstream out(compiledPath, std::ios::binary);
+			out.write((const char*)compiled.data(), compiled.size());
+		}
+		binary.points.push_back({count, RunBench([&] {
+			CollisionSystem collisions;
+			GameObjectSystem objects;
+			LoadScene(compiledPath, &collisions, &objects);
+			benchSink += collisions.CheckCollision({0, 0, 32, 32});
+		})});
+		source.points.push_back({count, RunBench([&] {
+			CollisionSystem collisions;
+			GameObjectSystem objects;
+			LoadSceneSource(path, &collisions, &objects);
+			benchSink += collisions.CheckCollision({0, 0, 32, 32});
+		})});
+		std::filesystem::remove(path);
+		std::filesystem::remove(compiledPath);
+	}
+	binary.Print();
+	source.Print();
+}
+
+int main(int argc, char** argv) {
+	std::string filter;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "-t" && i + 1 < argc) {
+			benchMinSeconds = atof(argv[++i]);
+		} else {
+			filter = arg;
+		}
+	}
+	SetTraceLogLevel(LOG_WARNING);
+
+	struct Entry {
+		const char* name;
+		void (*run)();
+	};
+	const Entry entries[] = {
+		{"collision", BenchCollisionQuery},
+		{"objects", BenchAllCollisions},
+		{"lookup", BenchGetObject},
+		{"tags", BenchTagQuery},
+		{"font", BenchFontCache},
+		{"dialog", BenchDialog},
+		{"path", BenchPathfinding},
+		{"flow", BenchFlowField},
+		{"particles", BenchParticles},
+		{"animation", BenchAnimation},
+		{"lod", BenchSimulationLod},
+		{"interact", BenchInteraction},
+		{"scene", BenchSceneLoad},
+	};
+	for (const auto& entry : entries) {
+		if (filter.empty() || std::string(entry.name).find(filter) != std::string::npos) {
+			entry.run();
+		}
+	}
+
+	UnloadAssetLoader();
+	return 0;
+}
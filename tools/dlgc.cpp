@@ -0,0 +1,65 @@
+// 对话脚本编译器：把文本脚本编译为运行时直接映射的二进制
+//
+// 用法: dlgc <输入.dlg> <输出.dlgb>
+//
+// 脚本格式见 include/dialogscript.h。
+#include "raylib.h"
+#include "../include/dialogscript.h"
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) {
+	if (argc < 3) {
+		std::cerr << "用法: dlgc <输入.dlg> <输出.dlgb>" << std::endl;
+		return 1;
+	}
+
+	std::ifstream in(argv[1], std::ios::binary);
+	if (!in) {
+		std::cerr << "无法读取: " << argv[1] << std::endl;
+		return 1;
+	}
+	std::string source((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+	std::vector<unsigned char> binary;
+	std::string error;
+	if (!CompileDialogScript(source, binary, error)) {
+		std::cerr << argv[1] << ": " << error << std::endl;
+		return 1;
+	}
+
+	// 检查跳转目标是否存在
+	const DialogScriptHeader* header = (const DialogScriptHeader*)binary.data();
+	const DialogIndexEntry* index = (const DialogIndexEntry*)(binary.data() + header->indexOffset);
+	auto exists = [&](int id) {
+		for (uint32_t i = 0; i < header->nodeCount; ++i) {
+			if (index[i].id == id) return true;
+		}
+		return false;
+	};
+	for (uint32_t i = 0; i < header->nodeCount; ++i) {
+		const DialogNodeRecord* record = (const DialogNodeRecord*)(binary.data() + index[i].nodeOffset);
+		const DialogOptionRecord* options = (const DialogOptionRecord*)(record + 1);
+		if (record->nextId != -1 && !exists(record->nextId)) {
+			std::cerr << "警告: 节点 " << record->id << " 指向不存在的节点 " << record->nextId << std::endl;
+		}
+		for (uint32_t k = 0; k < record->optionCount; ++k) {
+			if (options[k].nextId != -1 && !exists(options[k].nextId)) {
+				std::cerr << "警告: 节点 " << record->id << " 的选项指向不存在的节点 " << options[k].nextId << std::endl;
+			}
+		}
+	}
+
+	std::ofstream out(argv[2], std::ios::binary);
+	if (!out) {
+		std::cerr << "无法写入: " << argv[2] << std::endl;
+		return 1;
+	}
+	out.write((const char*)binary.data(), binary.size());
+	std::cout << "已写入 " << argv[2] << ": " << header->nodeCount << " 个节点, "
+	          << header->stringCount << " 个字符串, " << binary.size() << " 字节" << std::endl;
+	return 0;
+}
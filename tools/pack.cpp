@@ -0,0 +1,162 @@
+// 资源打包工具：把散文件打成一个可内存映射的资源包
+//
+// 用法: pack <输出.pak> [-z] [-a 对齐] <文件或目录>...
+//   -z      对能压缩的条目使用 DEFLATE（压缩后不小于原大小 90% 的保持原样）
+//   -a N    条目数据按 N 字节对齐（默认 16）
+//
+// 例: pack assets.pak -z resource save C:/Windows/Fonts/simhei.ttf
+// 包内路径即命令行给出的相对路径，统一使用 '/' 分隔。
+#include "raylib.h"
+#include "../include/assetpack.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+struct PackSource {
+	std::string name; // 包内路径
+	std::string file; // 磁盘路径
+	std::vector<unsigned char> stored;
+	uint32_t rawSize;
+	uint32_t flags;
+};
+
+static std::string NormalizeName(std::string name) {
+	std::replace(name.begin(), name.end(), '\\', '/');
+	while (name.rfind("./", 0) == 0) name.erase(0, 2);
+	return name;
+}
+
+static bool ReadWholeFile(const std::string& path, std::vector<unsigned char>& out) {
+	std::ifstream in(path, std::ios::binary);
+	if (!in) return false;
+	out.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	return true;
+}
+
+static void CollectSources(const std::string& arg, std::vector<PackSource>& sources) {
+	fs::path root(arg);
+	if (fs::is_directory(root)) {
+		for (const auto& item : fs::recursive_directory_iterator(root)) {
+			if (item.is_regular_file()) {
+				sources.push_back({NormalizeName(item.path().generic_string()), item.path().string(), {}, 0, 0});
+			}
+		}
+	} else if (fs::is_regular_file(root)) {
+		sources.push_back({NormalizeName(root.generic_string()), arg, {}, 0, 0});
+	} else {
+		std::cerr << "跳过不存在的路径: " << arg << std::endl;
+	}
+}
+
+static uint32_t AlignUp(uint32_t value, uint32_t alignment) {
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+int main(int argc, char** argv) {
+	if (argc < 3) {
+		std::cerr << "用法: pack <输出.pak> [-z] [-a 对齐] <文件或目录>..." << std::endl;
+		return 1;
+	}
+
+	std::string output = argv[1];
+	bool compress = false;
+	uint32_t alignment = 16;
+	std::vector<PackSource> sources;
+
+	for (int i = 2; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "-z") {
+			compress = true;
+		} else if (arg == "-a" && i + 1 < argc) {
+			alignment = (uint32_t)std::max(1, atoi(argv[++i]));
+		} else {
+			CollectSources(arg, sources);
+		}
+	}
+
+	// 索引按路径字节序排序，运行时二分查找
+	std::sort(sources.begin(), sources.end(), [](const PackSource& a, const PackSource& b) {
+		return a.name < b.name;
+	});
+	sources.erase(std::unique(sources.begin(), sources.end(), [](const PackSource& a, const PackSource& b) {
+		return a.name == b.name;
+	}), sources.end());
+
+	std::string names;
+	for (auto& source : sources) {
+		std::vector<unsigned char> raw;
+		if (!ReadWholeFile(source.file, raw)) {
+			std::cerr << "无法读取: " << source.file << std::endl;
+			return 1;
+		}
+		source.rawSize = (uint32_t)raw.size();
+		source.flags = 0;
+		source.stored = raw;
+
+		if (compress && !raw.empty()) {
+			int compSize = 0;
+			unsigned char* comp = CompressData(raw.data(), (int)raw.size(), &compSize);
+			if (comp && compSize > 0 && (uint64_t)compSize * 10 < (uint64_t)raw.size() * 9) {
+				source.stored.assign(comp, comp + compSize);
+				source.flags |= PACK_FLAG_DEFLATE;
+			}
+			if (comp) MemFree(comp);
+		}
+	}
+
+	PackHeader header;
+	memcpy(header.magic, PACK_MAGIC, 4);
+	header.version = PACK_VERSION;
+	header.entryCount = (uint32_t)sources.size();
+	header.indexOffset = sizeof(PackHeader);
+	header.alignment = alignment;
+	header.reserved = 0;
+
+	std::vector<PackEntry> entries(sources.size());
+	for (size_t i = 0; i < sources.size(); ++i) {
+		entries[i].nameOffset = (uint32_t)names.size();
+		entries[i].nameLength = (uint32_t)sources[i].name.size();
+		names += sources[i].name;
+	}
+	header.namesOffset = header.indexOffset + (uint32_t)(entries.size() * sizeof(PackEntry));
+	header.namesSize = (uint32_t)names.size();
+
+	uint32_t cursor = AlignUp(header.namesOffset + header.namesSize, alignment);
+	for (size_t i = 0; i < sources.size(); ++i) {
+		entries[i].dataOffset = cursor;
+		entries[i].storedSize = (uint32_t)sources[i].stored.size();
+		entries[i].rawSize = sources[i].rawSize;
+		entries[i].flags = sources[i].flags;
+		cursor = AlignUp(cursor + entries[i].storedSize, alignment);
+	}
+
+	std::ofstream out(output, std::ios::binary);
+	if (!out) {
+		std::cerr << "无法写入: " << output << std::endl;
+		return 1;
+	}
+	out.write((const char*)&header, sizeof(header));
+	out.write((const char*)entries.data(), entries.size() * sizeof(PackEntry));
+	out.write(names.data(), names.size());
+
+	uint64_t rawTotal = 0;
+	for (size_t i = 0; i < sources.size(); ++i) {
+		while ((uint32_t)out.tellp() < entries[i].dataOffset) out.put('\0');
+		out.write((const char*)sources[i].stored.data(), sources[i].stored.size());
+		rawTotal += sources[i].rawSize;
+		std::cout << (sources[i].flags & PACK_FLAG_DEFLATE ? "  [z] " : "      ")
+		          << sources[i].name << " (" << sources[i].rawSize << " -> "
+		          << sources[i].stored.size() << ")" << std::endl;
+	}
+	while ((uint32_t)out.tellp() < cursor) out.put('\0');
+
+	std::cout << "已写入 " << output << ": " << sources.size() << " 个条目, "
+	          << rawTotal << " -> " << cursor << " 字节" << std::endl;
+	return 0;
+}
@@ -0,0 +1,50 @@
+// 场景编译器：把文本场景编译为可直接批量加载的二进制（含预先建好的碰撞网格）
+//
+// 用法: scenec <输入.scene> <输出.sceneb>
+//
+// 场景格式见 include/scene.h。
+#include "raylib.h"
+#include "../include/scene.h"
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) {
+	if (argc < 3) {
+		std::cerr << "用法: scenec <输入.scene> <输出.sceneb>" << std::endl;
+		return 1;
+	}
+
+	std::ifstream in(argv[1], std::ios::binary);
+	if (!in) {
+		std::cerr << "无法读取: " << argv[1] << std::endl;
+		return 1;
+	}
+	std::string source((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+	std::vector<unsigned char> binary;
+	std::string error;
+	if (!CompileScene(source, binary, error)) {
+		std::cerr << argv[1] << ": " << error << std::endl;
+		return 1;
+	}
+
+	const SceneHeader* header = (const SceneHeader*)binary.data();
+	if (!header->hasSpawn) {
+		std::cerr << "警告: 没有 spawn，玩家位置由程序决定" << std::endl;
+	}
+
+	std::ofstream out(argv[2], std::ios::binary);
+	if (!out) {
+		std::cerr << "无法写入: " << argv[2] << std::endl;
+		return 1;
+	}
+	out.write((const char*)binary.data(), binary.size());
+	std::cout << "已写入 " << argv[2] << ": " << header->boxCount << " 个碰撞箱, "
+	          << header->objectCount << " 个物体, " << header->componentCount << " 个物体碰撞箱, "
+	          << header->interactCount << " 个可交互点, " << header->triggerCount << " 个触发区, 网格 "
+	          << header->gridCols << "x" << header->gridRows << ", " << binary.size() << " 字节" << std::endl;
+	return 0;
+}